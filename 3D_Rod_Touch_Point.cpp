@@ -4,33 +4,163 @@
 //Program Description: Given two points in 3D space along with corresponding lengths, return true if 
 //there exists a common endpoint between the two segments, and store said endpoint in a given variable.
 //If there is no common endpoint, return false. A hint vector is supplied for cases with multiple
-//common endpoints.
+//common endpoints. Coordinates and lengths can be float, double, for precision far from the origin, or
+//fixed point, each with its own epsilon given by rod_scalar_policy.
 //Program Use Cases: Collision detection in 3D could be used to detect when a player is close enough
 //to interact with another player or object. Another use could be to calculate where to trigger an
 //audio or visual effect when two objects, like a grenade and a wall, collide. It could also be used
 //in physics collisions, for everything from armor cloth interactions to player-boundary collisions.
+//Usage: 3D_Rod_Touch_Point [--benchmark <rod count> [--threads <count>]]
+//With --benchmark, times finding every pair of that many random rods with a common endpoint, by solving every
+//pair, by solving only the pairs found by the broad phase, find_rod_pair_candidates, one at a time and with
+//intersect_line_segments_batch, and with find_touching_rods on the given number of threads, one per hardware
+//thread by default.
+//Build: g++ -std=c++17 -O3 -fno-math-errno -fno-trapping-math -pthread 3D_Rod_Touch_Point.cpp -o 3D_Rod_Touch_Point
+//The last two flags let the compiler vectorize the plain loop intersect_line_segments_batch falls back on when the processor
+//has no AVX2; built with only -O2, that loop runs one pair at a time. They don't change any results.
+//The tests in 3D_Rod_Touch_Point_Test.cpp, which exit with 1 if any check fails, build the same way:
+//g++ -std=c++17 -O3 -fno-math-errno -fno-trapping-math -pthread 3D_Rod_Touch_Point_Test.cpp -o 3D_Rod_Touch_Point_Test
 //Last Updated: 04/11/21
 //*******************************************************************************************************
 
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <stdint.h>
 using namespace std;
 
-struct vector3d 
+//intersect_line_segments_batch uses hand-written AVX-512 or AVX2 kernels when the processor has them, chosen at run time;
+//build with ROD_TOUCH_POINT_SIMD defined to 0 to always use the plain C++ loop
+#ifndef ROD_TOUCH_POINT_SIMD
+#define ROD_TOUCH_POINT_SIMD 1
+#endif
+#if ROD_TOUCH_POINT_SIMD && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ROD_TOUCH_POINT_X86_KERNELS 1
+#else
+#define ROD_TOUCH_POINT_X86_KERNELS 0
+#endif
+
+//Fixed point number with fraction_bits of its raw_type below the binary point, for consumers that would rather trade range and
+//precision for smaller storage and integer math. Products and quotients are worked out in wide_type, twice the width of
+//raw_type, but the results are stored back in raw_type and wrap around if they don't fit; values converted from int or double
+//saturate at the ends of the range instead. With 32 bits and 16 of them fraction, fixed16_16, every value must stay below 32768,
+//and intersect_line_segments works out twice the squared distance between the origins, so they have to be less than 128 apart;
+//lengths have to stay below 181, since they are squared too. With 16 bits and 8 of them fraction, fixed8_8, values stay below
+//128, origins less than 8 apart and lengths below 11. Coordinates themselves can be anywhere in range, since only their
+//differences are multiplied
+template<typename raw_type, typename wide_type, int fraction_bits>
+struct fixed_point
 {
-	float x;
-	float y;
-	float z;
+	raw_type raw; //The value times 2^fraction_bits
+
+	constexpr fixed_point() : raw(0) {}
+	constexpr explicit fixed_point(int value) : raw(saturatedRaw(double(value) * double(wide_type(1) << fraction_bits))) {}
+	constexpr explicit fixed_point(double value) : raw(saturatedRaw(value * double(wide_type(1) << fraction_bits) + (value < 0 ? -0.5 : 0.5))) {}
+	constexpr explicit operator double() const { return double(raw) / double(raw_type(1) << fraction_bits); }
+	static constexpr fixed_point from_raw(raw_type raw_value) { fixed_point value; value.raw = raw_value; return value; }
+	static constexpr raw_type saturatedRaw(double scaled_value) //Truncates a value already scaled by 2^fraction_bits to the nearest raw value in range; 0 for NaN
+	{
+		return scaled_value >= double(numeric_limits<raw_type>::max()) ? numeric_limits<raw_type>::max()
+			: scaled_value <= double(numeric_limits<raw_type>::min()) ? numeric_limits<raw_type>::min()
+			: scaled_value == scaled_value ? raw_type(scaled_value) : raw_type(0);
+	}
+
+	constexpr fixed_point operator-() const { return from_raw(-raw); }
+	constexpr fixed_point operator+(fixed_point other) const { return from_raw(raw + other.raw); }
+	constexpr fixed_point operator-(fixed_point other) const { return from_raw(raw - other.raw); }
+	constexpr fixed_point operator*(fixed_point other) const { return from_raw(raw_type((wide_type(raw) * other.raw) >> fraction_bits)); }
+	constexpr fixed_point operator/(fixed_point other) const //Division by 0 gives the largest value of the dividend's sign, the way a float would give infinity
+	{
+		if(other.raw == 0)
+		{
+			return from_raw(raw < 0 ? -numeric_limits<raw_type>::max() : numeric_limits<raw_type>::max());
+		}
+		return from_raw(raw_type(wide_type(raw) * (wide_type(1) << fraction_bits) / other.raw)); //Multiplied, since shifting a negative value left is undefined
+	}
+	constexpr bool operator<(fixed_point other) const { return raw < other.raw; }
+	constexpr bool operator<=(fixed_point other) const { return raw <= other.raw; }
 };
 
+template<typename raw_type, typename wide_type, int fraction_bits>
+constexpr fixed_point<raw_type, wide_type, fraction_bits> abs(fixed_point<raw_type, wide_type, fraction_bits> value)
+{
+	return value.raw < 0 ? -value : value;
+}
+
+//Square root, rounded down; 0 for negative values, where a float would give NaN
+template<typename raw_type, typename wide_type, int fraction_bits>
+fixed_point<raw_type, wide_type, fraction_bits> sqrt(fixed_point<raw_type, wide_type, fraction_bits> value)
+{
+	if(value.raw <= 0)
+	{
+		return fixed_point<raw_type, wide_type, fraction_bits>();
+	}
+	wide_type square = wide_type(value.raw) << fraction_bits, root = wide_type(sqrt(double(square))); //The root of the raw value times 2^fraction_bits is the raw root
+	while(root * root > square)
+	{
+		root--;
+	}
+	while((root + 1) * (root + 1) <= square)
+	{
+		root++;
+	}
+	return fixed_point<raw_type, wide_type, fraction_bits>::from_raw(raw_type(root));
+}
+
+typedef fixed_point<int32_t, int64_t, 16> fixed16_16;
+typedef fixed_point<int16_t, int32_t, 8> fixed8_8;
+
+//Tolerance of the equality checks in intersect_line_segments for each scalar type it can be used with; can be changed for higher
+//or lower precision. Each should be well above the rounding error of the type over the distances in use
+template<typename scalar_type>
+struct rod_scalar_policy;
+
+template<>
+struct rod_scalar_policy<float>
+{
+	static constexpr float epsilon = 0.001f;
+};
+
+template<>
+struct rod_scalar_policy<double>
+{
+	static constexpr double epsilon = 0.000001;
+};
+
+template<typename raw_type, typename wide_type, int fraction_bits>
+struct rod_scalar_policy<fixed_point<raw_type, wide_type, fraction_bits>>
+{
+	typedef fixed_point<raw_type, wide_type, fraction_bits> fixed_type;
+	static constexpr fixed_type epsilon = fixed_type::from_raw(max(fixed_type(0.001).raw, raw_type(4))); //Same as float, but no less than a few steps
+};
+
+template<typename scalar_type>
+struct basic_vector3d
+{
+	scalar_type x;
+	scalar_type y;
+	scalar_type z;
+};
+
+typedef basic_vector3d<float> vector3d;
 typedef vector3d point3d;
 
 //subtracts vector v2 from v1
-vector3d subtractVectors(vector3d &v1, vector3d &v2)
+template<typename scalar_type>
+basic_vector3d<scalar_type> subtractVectors(basic_vector3d<scalar_type> &v1, basic_vector3d<scalar_type> &v2)
 
 {
-    vector3d tempVector;
+    basic_vector3d<scalar_type> tempVector;
     tempVector.x = v1.x - v2.x;
     tempVector.y = v1.y - v2.y;
     tempVector.z = v1.z - v2.z;
@@ -38,10 +168,11 @@ vector3d subtractVectors(vector3d &v1, vector3d &v2)
 }
 
 //adds two vectors together
-vector3d addVectors(vector3d &v1, vector3d &v2)
+template<typename scalar_type>
+basic_vector3d<scalar_type> addVectors(basic_vector3d<scalar_type> &v1, basic_vector3d<scalar_type> &v2)
 
 {
-    vector3d tempVector;
+    basic_vector3d<scalar_type> tempVector;
     tempVector.x = v2.x + v1.x;
     tempVector.y = v2.y + v1.y;
     tempVector.z = v2.z + v1.z;
@@ -49,10 +180,11 @@ vector3d addVectors(vector3d &v1, vector3d &v2)
 }
 
 //multiplies a vector by a scalar
-vector3d scalarMultiply (float scalar, vector3d &v)
+template<typename scalar_type>
+basic_vector3d<scalar_type> scalarMultiply (scalar_type scalar, basic_vector3d<scalar_type> &v)
 
 {
-	vector3d tempVector;
+	basic_vector3d<scalar_type> tempVector;
 	tempVector.x = v.x * scalar;
 	tempVector.y = v.y * scalar;
 	tempVector.z = v.z * scalar;
@@ -60,18 +192,20 @@ vector3d scalarMultiply (float scalar, vector3d &v)
 }
 
 //returns the magnitude of a given vector
-float vectorMagnitude(vector3d &v)
+template<typename scalar_type>
+scalar_type vectorMagnitude(basic_vector3d<scalar_type> &v)
 
 {
 	return sqrt(v.x*v.x+v.y*v.y+v.z*v.z);
 }
 
 //normalizes a given vector to have a magnitude of 1
-vector3d normalizeVector(vector3d &v)
+template<typename scalar_type>
+basic_vector3d<scalar_type> normalizeVector(basic_vector3d<scalar_type> &v)
 
 {
-	vector3d tempVector;
-	float mag = vectorMagnitude(v);
+	basic_vector3d<scalar_type> tempVector;
+	scalar_type mag = vectorMagnitude(v);
 	tempVector.x = v.x/mag;
 	tempVector.y = v.y/mag;
 	tempVector.z = v.z/mag;
@@ -79,37 +213,43 @@ vector3d normalizeVector(vector3d &v)
 }
 
 //returns the dot product of v1 and v1
-float dotProduct(vector3d &v1, vector3d &v2)
+template<typename scalar_type>
+scalar_type dotProduct(basic_vector3d<scalar_type> &v1, basic_vector3d<scalar_type> &v2)
 {
 	return ((v1.x * v2.x) + (v1.y * v2.y) + (v1.z * v2.z));
 }
 
 //returns the cross product of v1 X v2
-vector3d crossProduct(vector3d &v1, vector3d &v2)
+template<typename scalar_type>
+basic_vector3d<scalar_type> crossProduct(basic_vector3d<scalar_type> &v1, basic_vector3d<scalar_type> &v2)
 
 {
-	vector3d tempVector;
+	basic_vector3d<scalar_type> tempVector;
 	tempVector.x = (v1.y * v2.z) - (v1.z * v2.y);
 	tempVector.y = (v1.z * v2.x) - (v1.x * v2.z);
 	tempVector.z = (v1.x * v2.y) - (v1.y * v2.x);
 	return tempVector;
 }
 
+//Works with float, double or fixed_point coordinates and lengths, with the epsilon given by rod_scalar_policy
+template<typename scalar_type>
 bool intersect_line_segments(
-	point3d position_0,			// origin of first line segment.
-	float length_0,			// length of first line segment.
-	point3d position_1,			// origin of second line segment.
-	float length_1,			// length of second line segment.
-	vector3d hint_direction,		// in the event there are multiple solutions, return the
+	basic_vector3d<scalar_type> position_0,	// origin of first line segment.
+	scalar_type length_0,			// length of first line segment.
+	basic_vector3d<scalar_type> position_1,	// origin of second line segment.
+	scalar_type length_1,			// length of second line segment.
+	basic_vector3d<scalar_type> hint_direction,	// in the event there are multiple solutions, return the
 						// one furthest in this direction.
-	point3d *out_common_end_position)	// if result is true, point where both line segments can be
+	basic_vector3d<scalar_type> *out_common_end_position)	// if result is true, point where both line segments can be
 						// oriented to end. otherwise uninitialized.
 {
+	typedef basic_vector3d<scalar_type> vector3d; //The vectors below use the same scalar type as the arguments
+	typedef basic_vector3d<scalar_type> point3d;
 	
-	float epsilon = 0.001f; //Value used for floating point equality checks; can be changed for higher or lower precision
+	const scalar_type epsilon = rod_scalar_policy<scalar_type>::epsilon; //Value used for floating point equality checks
     vector3d differenceVector = subtractVectors(position_1, position_0); // Distance between the two origin points
-	float differenceMagnitude = vectorMagnitude(differenceVector); //Length of the difference between origin points
-	vector3d vectorToAdd = {0,0,0}; //Vector to be reused throughout program to perform operations on a vector before adding it; this allows all the helper functions to pass by reference and save memory
+	scalar_type differenceMagnitude = vectorMagnitude(differenceVector); //Length of the difference between origin points
+	vector3d vectorToAdd = {scalar_type(0),scalar_type(0),scalar_type(0)}; //Vector to be reused throughout program to perform operations on a vector before adding it; this allows all the helper functions to pass by reference and save memory
 
 	//A sphere can be drawn by rotating a rod of any length around a point; there is a common endpoint only if
 	//two given spheres intersect at any points. They will either intersect at exactly one point, a circle of points,
@@ -168,7 +308,7 @@ bool intersect_line_segments(
 	{
 		//Add the origin position of the larger "sphere" to the normalized difference vector scaled by length_0;
 		//the difference vector is also flipped in direction to get position_0 - position_1 for this calculation
-		vectorToAdd =  scalarMultiply(-1 * length_1/differenceMagnitude, differenceVector);
+		vectorToAdd =  scalarMultiply(scalar_type(-1) * length_1/differenceMagnitude, differenceVector);
 		*out_common_end_position = addVectors(position_1, vectorToAdd);
 		return true;
 	}
@@ -179,13 +319,13 @@ bool intersect_line_segments(
 	//Finding the center of the circle, using position_0 as a reference:
 
 	//Use some trig to calculate the length of the difference between position_0 and the circle center
-	float distanceRatio = 0.5f + ((length_0 * length_0 - length_1 * length_1)/(2 * differenceMagnitude * differenceMagnitude));
+	scalar_type distanceRatio = scalar_type(0.5) + ((length_0 * length_0 - length_1 * length_1)/(scalar_type(2) * differenceMagnitude * differenceMagnitude));
 
 	vectorToAdd = scalarMultiply(distanceRatio, differenceVector);
 	point3d circleCenter = addVectors(position_0, vectorToAdd); //Add position 0 to the difference vector scaled by the distance ratio
 
 	//Radius is easily calculated using Pythagorean theorem
-	float circleRadius = sqrt((length_0 * length_0) - (distanceRatio * differenceMagnitude * distanceRatio * differenceMagnitude));
+	scalar_type circleRadius = sqrt((length_0 * length_0) - (distanceRatio * differenceMagnitude * distanceRatio * differenceMagnitude));
 
 	//Normal of the circle is simply the difference vector normalized
 	vector3d circleNormal = normalizeVector(differenceVector);
@@ -196,7 +336,7 @@ bool intersect_line_segments(
 	if(abs(normalHintCrossProduct.x) <= epsilon && abs(normalHintCrossProduct.y) <= epsilon && 
 		abs(normalHintCrossProduct.z) <= epsilon) //If cross product is {0,0,0}, vectors are equal or exact opposite
 	{
-		vector3d hintVectorAddition = {1,0,0}; //Arbitrary vector to be added to the hint direction if it points in the same direction as the normal of the intersection circle
+		vector3d hintVectorAddition = {scalar_type(1),scalar_type(0),scalar_type(0)}; //Arbitrary vector to be added to the hint direction if it points in the same direction as the normal of the intersection circle
 		hint_direction = addVectors(hint_direction, hintVectorAddition);
 	}
 
@@ -209,8 +349,736 @@ bool intersect_line_segments(
 	return true;
 }
 
-int main()
+//A batch of rod pairs for intersect_line_segments_batch, as one array per coordinate so that pair i is element i of every array
+struct line_segment_pair_batch
+{
+	const float *position_0_x, *position_0_y, *position_0_z; //Origins of the first line segments
+	const float *length_0; //Lengths of the first line segments
+	const float *position_1_x, *position_1_y, *position_1_z; //Origins of the second line segments
+	const float *length_1; //Lengths of the second line segments
+	const float *hint_x, *hint_y, *hint_z; //Hint direction of each pair, for pairs with multiple solutions
+};
+
+//Results of intersect_line_segments_batch, again one array per coordinate
+struct line_segment_pair_results
+{
+	float *common_end_x, *common_end_y, *common_end_z; //Common endpoint of each pair, or 0 where there is none
+	unsigned char *has_common_end; //1 where the pair has a common endpoint, otherwise 0
+};
+
+//Plain C++ body of intersect_line_segments_batch, for pairs first_pair up to pair_count; the arrays are passed separately and
+//marked __restrict, so the compiler knows the results don't overlap the inputs and can vectorize without checking at run time
+static void intersectLineSegmentArrays(const float *__restrict position0X, const float *__restrict position0Y, const float *__restrict position0Z,
+	const float *__restrict lengths0, const float *__restrict position1X, const float *__restrict position1Y, const float *__restrict position1Z,
+	const float *__restrict lengths1, const float *__restrict hintsX, const float *__restrict hintsY, const float *__restrict hintsZ,
+	float *__restrict commonEndX, float *__restrict commonEndY, float *__restrict commonEndZ, unsigned char *__restrict hasCommonEnd, size_t first_pair, size_t pair_count)
+{
+	const float epsilon = rod_scalar_policy<float>::epsilon; //Same as intersect_line_segments
+	for(size_t pairIndex = first_pair; pairIndex < pair_count; pairIndex++)
+	{
+		float length0 = lengths0[pairIndex], length1 = lengths1[pairIndex];
+		float differenceX = position1X[pairIndex] - position0X[pairIndex];
+		float differenceY = position1Y[pairIndex] - position0Y[pairIndex];
+		float differenceZ = position1Z[pairIndex] - position0Z[pairIndex];
+		float differenceMagnitude = sqrt(differenceX*differenceX+differenceY*differenceY+differenceZ*differenceZ);
+
+		//The same tests as intersect_line_segments, in the same order; the first one that holds decides the result
+		bool isDisjoint = (length0 + length1) - differenceMagnitude <= -epsilon;
+		bool isEnclosedIn0 = (length1 - length0 < -epsilon) & ((differenceMagnitude + length1) - length0 < -epsilon);
+		bool isEnclosedIn1 = (length0 - length1 < -epsilon) & ((differenceMagnitude + length0) - length1 < -epsilon);
+		bool isCoincident = (abs(length1-length0) <= epsilon) & (abs(differenceX) <= epsilon) & (abs(differenceY) <= epsilon) & (abs(differenceZ) <= epsilon);
+		bool isTouchingFrom0 = ((length0 + length1) - differenceMagnitude <= epsilon) | ((length1 - length0 < -epsilon) & (abs((length1 + differenceMagnitude) - length0) <= epsilon));
+		bool isTouchingFrom1 = (length0 - length1 < -epsilon) & (abs((length0 + differenceMagnitude) - length1) <= epsilon);
+
+		//Coincident spheres: the point on the sphere furthest in the hint direction
+		float hintX = hintsX[pairIndex], hintY = hintsY[pairIndex], hintZ = hintsZ[pairIndex];
+		float hintMagnitude = sqrt(hintX*hintX+hintY*hintY+hintZ*hintZ);
+		float coincidentX = (hintX/hintMagnitude) * length0 + position0X[pairIndex];
+		float coincidentY = (hintY/hintMagnitude) * length0 + position0Y[pairIndex];
+		float coincidentZ = (hintZ/hintMagnitude) * length0 + position0Z[pairIndex];
+
+		//Spheres touching at one point: along the difference vector from position_0, or back along it from position_1
+		float touchingScale = isTouchingFrom1 ? -1 * length1/differenceMagnitude : length0/differenceMagnitude;
+		float touchingX = differenceX * touchingScale + (isTouchingFrom1 ? position1X[pairIndex] : position0X[pairIndex]);
+		float touchingY = differenceY * touchingScale + (isTouchingFrom1 ? position1Y[pairIndex] : position0Y[pairIndex]);
+		float touchingZ = differenceZ * touchingScale + (isTouchingFrom1 ? position1Z[pairIndex] : position0Z[pairIndex]);
+
+		//Spheres meeting in a circle: the point on the circle furthest in the hint direction
+		float distanceRatio = 0.5f + ((length0 * length0 - length1 * length1)/(2 * differenceMagnitude * differenceMagnitude));
+		float circleRadius = sqrt((length0 * length0) - (distanceRatio * differenceMagnitude * distanceRatio * differenceMagnitude));
+		float normalX = differenceX/differenceMagnitude, normalY = differenceY/differenceMagnitude, normalZ = differenceZ/differenceMagnitude;
+		bool isHintAlongNormal = (abs((normalY * hintZ) - (normalZ * hintY)) <= epsilon) & (abs((normalZ * hintX) - (normalX * hintZ)) <= epsilon) &
+			(abs((normalX * hintY) - (normalY * hintX)) <= epsilon);
+		hintX = isHintAlongNormal ? 1 + hintX : hintX;
+		hintY = isHintAlongNormal ? 0 + hintY : hintY;
+		hintZ = isHintAlongNormal ? 0 + hintZ : hintZ;
+		float normalHintDot = (normalX * hintX) + (normalY * hintY) + (normalZ * hintZ);
+		float planeX = hintX - normalX * normalHintDot, planeY = hintY - normalY * normalHintDot, planeZ = hintZ - normalZ * normalHintDot;
+		float planeMagnitude = sqrt(planeX*planeX+planeY*planeY+planeZ*planeZ);
+		float circleX = (planeX/planeMagnitude) * circleRadius + (differenceX * distanceRatio + position0X[pairIndex]);
+		float circleY = (planeY/planeMagnitude) * circleRadius + (differenceY * distanceRatio + position0Y[pairIndex]);
+		float circleZ = (planeZ/planeMagnitude) * circleRadius + (differenceZ * distanceRatio + position0Z[pairIndex]);
+
+		bool hasEnd = !(isDisjoint | isEnclosedIn0 | isEnclosedIn1);
+		bool useTouching = isTouchingFrom0 | isTouchingFrom1;
+		float resultX = isCoincident ? coincidentX : (useTouching ? touchingX : circleX);
+		float resultY = isCoincident ? coincidentY : (useTouching ? touchingY : circleY);
+		float resultZ = isCoincident ? coincidentZ : (useTouching ? touchingZ : circleZ);
+		commonEndX[pairIndex] = hasEnd ? resultX : 0;
+		commonEndY[pairIndex] = hasEnd ? resultY : 0;
+		commonEndZ[pairIndex] = hasEnd ? resultZ : 0;
+		hasCommonEnd[pairIndex] = hasEnd;
+	}
+}
+
+//Runs the plain C++ loop over the pairs from first_pair on, to finish the pairs a kernel leaves over
+static void intersectLineSegmentPairs(const line_segment_pair_batch &pairs, line_segment_pair_results &results, size_t first_pair, size_t pair_count)
+{
+	intersectLineSegmentArrays(pairs.position_0_x, pairs.position_0_y, pairs.position_0_z, pairs.length_0, pairs.position_1_x, pairs.position_1_y,
+		pairs.position_1_z, pairs.length_1, pairs.hint_x, pairs.hint_y, pairs.hint_z, results.common_end_x, results.common_end_y, results.common_end_z,
+		results.has_common_end, first_pair, pair_count);
+}
+
+static void intersectLineSegmentsScalar(const line_segment_pair_batch &pairs, line_segment_pair_results &results, size_t pair_count)
+{
+	intersectLineSegmentPairs(pairs, results, 0, pair_count);
+}
+
+#if ROD_TOUCH_POINT_X86_KERNELS
+//8 pairs at a time; each step is the same operation, in the same order, as in intersectLineSegmentArrays, so the results are
+//identical to it as long as neither is built to contract multiplies and adds into FMA instructions. Comparison masks stand in for
+//the bools and blends for the conditional selects; the pairs left over at the end go through the plain loop
+__attribute__((target("avx2")))
+static void intersectLineSegmentsAvx2(const line_segment_pair_batch &pairs, line_segment_pair_results &results, size_t pair_count)
 {
+	const __m256 epsilon = _mm256_set1_ps(rod_scalar_policy<float>::epsilon), negativeEpsilon = _mm256_set1_ps(-rod_scalar_policy<float>::epsilon);
+	const __m256 signBit = _mm256_set1_ps(-0.0f), zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), minusOne = _mm256_set1_ps(-1.0f), half = _mm256_set1_ps(0.5f), two = _mm256_set1_ps(2.0f);
+	size_t pairIndex = 0;
+	for(; pairIndex + 8 <= pair_count; pairIndex += 8)
+	{
+		__m256 length0 = _mm256_loadu_ps(pairs.length_0 + pairIndex), length1 = _mm256_loadu_ps(pairs.length_1 + pairIndex);
+		__m256 position0X = _mm256_loadu_ps(pairs.position_0_x + pairIndex), position0Y = _mm256_loadu_ps(pairs.position_0_y + pairIndex), position0Z = _mm256_loadu_ps(pairs.position_0_z + pairIndex);
+		__m256 position1X = _mm256_loadu_ps(pairs.position_1_x + pairIndex), position1Y = _mm256_loadu_ps(pairs.position_1_y + pairIndex), position1Z = _mm256_loadu_ps(pairs.position_1_z + pairIndex);
+		__m256 differenceX = _mm256_sub_ps(position1X, position0X), differenceY = _mm256_sub_ps(position1Y, position0Y), differenceZ = _mm256_sub_ps(position1Z, position0Z);
+		__m256 differenceMagnitude = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(differenceX, differenceX), _mm256_mul_ps(differenceY, differenceY)), _mm256_mul_ps(differenceZ, differenceZ)));
+
+		__m256 lengthSum = _mm256_add_ps(length0, length1);
+		__m256 is1Shorter = _mm256_cmp_ps(_mm256_sub_ps(length1, length0), negativeEpsilon, _CMP_LT_OQ);
+		__m256 is0Shorter = _mm256_cmp_ps(_mm256_sub_ps(length0, length1), negativeEpsilon, _CMP_LT_OQ);
+		__m256 isDisjoint = _mm256_cmp_ps(_mm256_sub_ps(lengthSum, differenceMagnitude), negativeEpsilon, _CMP_LE_OQ);
+		__m256 isEnclosedIn0 = _mm256_and_ps(is1Shorter, _mm256_cmp_ps(_mm256_sub_ps(_mm256_add_ps(differenceMagnitude, length1), length0), negativeEpsilon, _CMP_LT_OQ));
+		__m256 isEnclosedIn1 = _mm256_and_ps(is0Shorter, _mm256_cmp_ps(_mm256_sub_ps(_mm256_add_ps(differenceMagnitude, length0), length1), negativeEpsilon, _CMP_LT_OQ));
+		__m256 isCoincident = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(_mm256_andnot_ps(signBit, _mm256_sub_ps(length1, length0)), epsilon, _CMP_LE_OQ),
+			_mm256_cmp_ps(_mm256_andnot_ps(signBit, differenceX), epsilon, _CMP_LE_OQ)), _mm256_and_ps(_mm256_cmp_ps(_mm256_andnot_ps(signBit, differenceY), epsilon, _CMP_LE_OQ),
+			_mm256_cmp_ps(_mm256_andnot_ps(signBit, differenceZ), epsilon, _CMP_LE_OQ)));
+		__m256 isTouchingFrom0 = _mm256_or_ps(_mm256_cmp_ps(_mm256_sub_ps(lengthSum, differenceMagnitude), epsilon, _CMP_LE_OQ),
+			_mm256_and_ps(is1Shorter, _mm256_cmp_ps(_mm256_andnot_ps(signBit, _mm256_sub_ps(_mm256_add_ps(length1, differenceMagnitude), length0)), epsilon, _CMP_LE_OQ)));
+		__m256 isTouchingFrom1 = _mm256_and_ps(is0Shorter, _mm256_cmp_ps(_mm256_andnot_ps(signBit, _mm256_sub_ps(_mm256_add_ps(length0, differenceMagnitude), length1)), epsilon, _CMP_LE_OQ));
+
+		//Coincident spheres
+		__m256 hintX = _mm256_loadu_ps(pairs.hint_x + pairIndex), hintY = _mm256_loadu_ps(pairs.hint_y + pairIndex), hintZ = _mm256_loadu_ps(pairs.hint_z + pairIndex);
+		__m256 hintMagnitude = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(hintX, hintX), _mm256_mul_ps(hintY, hintY)), _mm256_mul_ps(hintZ, hintZ)));
+		__m256 coincidentX = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(hintX, hintMagnitude), length0), position0X);
+		__m256 coincidentY = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(hintY, hintMagnitude), length0), position0Y);
+		__m256 coincidentZ = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(hintZ, hintMagnitude), length0), position0Z);
+
+		//Spheres touching at one point
+		__m256 touchingScale = _mm256_blendv_ps(_mm256_div_ps(length0, differenceMagnitude), _mm256_div_ps(_mm256_mul_ps(minusOne, length1), differenceMagnitude), isTouchingFrom1);
+		__m256 touchingX = _mm256_add_ps(_mm256_mul_ps(differenceX, touchingScale), _mm256_blendv_ps(position0X, position1X, isTouchingFrom1));
+		__m256 touchingY = _mm256_add_ps(_mm256_mul_ps(differenceY, touchingScale), _mm256_blendv_ps(position0Y, position1Y, isTouchingFrom1));
+		__m256 touchingZ = _mm256_add_ps(_mm256_mul_ps(differenceZ, touchingScale), _mm256_blendv_ps(position0Z, position1Z, isTouchingFrom1));
+
+		//Spheres meeting in a circle
+		__m256 distanceRatio = _mm256_add_ps(half, _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(length0, length0), _mm256_mul_ps(length1, length1)),
+			_mm256_mul_ps(_mm256_mul_ps(two, differenceMagnitude), differenceMagnitude)));
+		__m256 centerDistance = _mm256_mul_ps(distanceRatio, differenceMagnitude);
+		__m256 circleRadius = _mm256_sqrt_ps(_mm256_sub_ps(_mm256_mul_ps(length0, length0), _mm256_mul_ps(_mm256_mul_ps(centerDistance, distanceRatio), differenceMagnitude)));
+		__m256 normalX = _mm256_div_ps(differenceX, differenceMagnitude), normalY = _mm256_div_ps(differenceY, differenceMagnitude), normalZ = _mm256_div_ps(differenceZ, differenceMagnitude);
+		__m256 isHintAlongNormal = _mm256_and_ps(_mm256_and_ps(
+			_mm256_cmp_ps(_mm256_andnot_ps(signBit, _mm256_sub_ps(_mm256_mul_ps(normalY, hintZ), _mm256_mul_ps(normalZ, hintY))), epsilon, _CMP_LE_OQ),
+			_mm256_cmp_ps(_mm256_andnot_ps(signBit, _mm256_sub_ps(_mm256_mul_ps(normalZ, hintX), _mm256_mul_ps(normalX, hintZ))), epsilon, _CMP_LE_OQ)),
+			_mm256_cmp_ps(_mm256_andnot_ps(signBit, _mm256_sub_ps(_mm256_mul_ps(normalX, hintY), _mm256_mul_ps(normalY, hintX))), epsilon, _CMP_LE_OQ));
+		hintX = _mm256_blendv_ps(hintX, _mm256_add_ps(one, hintX), isHintAlongNormal);
+		hintY = _mm256_blendv_ps(hintY, _mm256_add_ps(zero, hintY), isHintAlongNormal);
+		hintZ = _mm256_blendv_ps(hintZ, _mm256_add_ps(zero, hintZ), isHintAlongNormal);
+		__m256 normalHintDot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalX, hintX), _mm256_mul_ps(normalY, hintY)), _mm256_mul_ps(normalZ, hintZ));
+		__m256 planeX = _mm256_sub_ps(hintX, _mm256_mul_ps(normalX, normalHintDot));
+		__m256 planeY = _mm256_sub_ps(hintY, _mm256_mul_ps(normalY, normalHintDot));
+		__m256 planeZ = _mm256_sub_ps(hintZ, _mm256_mul_ps(normalZ, normalHintDot));
+		__m256 planeMagnitude = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX, planeX), _mm256_mul_ps(planeY, planeY)), _mm256_mul_ps(planeZ, planeZ)));
+		__m256 circleX = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(planeX, planeMagnitude), circleRadius), _mm256_add_ps(_mm256_mul_ps(differenceX, distanceRatio), position0X));
+		__m256 circleY = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(planeY, planeMagnitude), circleRadius), _mm256_add_ps(_mm256_mul_ps(differenceY, distanceRatio), position0Y));
+		__m256 circleZ = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(planeZ, planeMagnitude), circleRadius), _mm256_add_ps(_mm256_mul_ps(differenceZ, distanceRatio), position0Z));
+
+		__m256 hasNoEnd = _mm256_or_ps(isDisjoint, _mm256_or_ps(isEnclosedIn0, isEnclosedIn1));
+		__m256 useTouching = _mm256_or_ps(isTouchingFrom0, isTouchingFrom1);
+		__m256 resultX = _mm256_blendv_ps(_mm256_blendv_ps(circleX, touchingX, useTouching), coincidentX, isCoincident);
+		__m256 resultY = _mm256_blendv_ps(_mm256_blendv_ps(circleY, touchingY, useTouching), coincidentY, isCoincident);
+		__m256 resultZ = _mm256_blendv_ps(_mm256_blendv_ps(circleZ, touchingZ, useTouching), coincidentZ, isCoincident);
+		_mm256_storeu_ps(results.common_end_x + pairIndex, _mm256_blendv_ps(resultX, zero, hasNoEnd));
+		_mm256_storeu_ps(results.common_end_y + pairIndex, _mm256_blendv_ps(resultY, zero, hasNoEnd));
+		_mm256_storeu_ps(results.common_end_z + pairIndex, _mm256_blendv_ps(resultZ, zero, hasNoEnd));
+		//Narrow the 32 bit lanes of the mask to one byte per pair: 0 where there's no end, 1 where there is one
+		__m256i hasEnd = _mm256_add_epi32(_mm256_castps_si256(hasNoEnd), _mm256_set1_epi32(1));
+		__m128i hasEndWords = _mm_packus_epi32(_mm256_castsi256_si128(hasEnd), _mm256_extracti128_si256(hasEnd, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(results.has_common_end + pairIndex), _mm_packus_epi16(hasEndWords, hasEndWords));
+	}
+	intersectLineSegmentPairs(pairs, results, pairIndex, pair_count);
+}
+
+//16 pairs at a time, following intersectLineSegmentsAvx2 but with the tests kept in mask registers and the results picked with
+//masked blends; the last pairs are loaded and stored under a mask rather than going through the plain loop. AVX-512 includes FMA,
+//which GCC would otherwise use for multiplies followed by adds, so contraction is turned off to keep the results identical to the
+//other versions
+#if defined(__clang__)
+__attribute__((target("avx512f")))
+#else
+__attribute__((target("avx512f"), optimize("fp-contract=off")))
+#endif
+static void intersectLineSegmentsAvx512(const line_segment_pair_batch &pairs, line_segment_pair_results &results, size_t pair_count)
+{
+	const __m512 epsilon = _mm512_set1_ps(rod_scalar_policy<float>::epsilon), negativeEpsilon = _mm512_set1_ps(-rod_scalar_policy<float>::epsilon);
+	const __m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.0f), minusOne = _mm512_set1_ps(-1.0f), half = _mm512_set1_ps(0.5f), two = _mm512_set1_ps(2.0f);
+	for(size_t pairIndex = 0; pairIndex < pair_count; pairIndex += 16)
+	{
+		__mmask16 pairMask = pair_count - pairIndex >= 16 ? 0xFFFF : __mmask16((1u << (pair_count - pairIndex)) - 1);
+		__m512 length0 = _mm512_maskz_loadu_ps(pairMask, pairs.length_0 + pairIndex), length1 = _mm512_maskz_loadu_ps(pairMask, pairs.length_1 + pairIndex);
+		__m512 position0X = _mm512_maskz_loadu_ps(pairMask, pairs.position_0_x + pairIndex), position0Y = _mm512_maskz_loadu_ps(pairMask, pairs.position_0_y + pairIndex);
+		__m512 position0Z = _mm512_maskz_loadu_ps(pairMask, pairs.position_0_z + pairIndex), position1X = _mm512_maskz_loadu_ps(pairMask, pairs.position_1_x + pairIndex);
+		__m512 position1Y = _mm512_maskz_loadu_ps(pairMask, pairs.position_1_y + pairIndex), position1Z = _mm512_maskz_loadu_ps(pairMask, pairs.position_1_z + pairIndex);
+		__m512 differenceX = _mm512_sub_ps(position1X, position0X), differenceY = _mm512_sub_ps(position1Y, position0Y), differenceZ = _mm512_sub_ps(position1Z, position0Z);
+		__m512 differenceMagnitude = _mm512_maskz_sqrt_ps(pairMask, _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(differenceX, differenceX), _mm512_mul_ps(differenceY, differenceY)), _mm512_mul_ps(differenceZ, differenceZ)));
+
+		__m512 lengthSum = _mm512_add_ps(length0, length1);
+		__mmask16 is1Shorter = _mm512_cmp_ps_mask(_mm512_sub_ps(length1, length0), negativeEpsilon, _CMP_LT_OQ);
+		__mmask16 is0Shorter = _mm512_cmp_ps_mask(_mm512_sub_ps(length0, length1), negativeEpsilon, _CMP_LT_OQ);
+		__mmask16 isDisjoint = _mm512_cmp_ps_mask(_mm512_sub_ps(lengthSum, differenceMagnitude), negativeEpsilon, _CMP_LE_OQ);
+		__mmask16 isEnclosedIn0 = _mm512_mask_cmp_ps_mask(is1Shorter, _mm512_sub_ps(_mm512_add_ps(differenceMagnitude, length1), length0), negativeEpsilon, _CMP_LT_OQ);
+		__mmask16 isEnclosedIn1 = _mm512_mask_cmp_ps_mask(is0Shorter, _mm512_sub_ps(_mm512_add_ps(differenceMagnitude, length0), length1), negativeEpsilon, _CMP_LT_OQ);
+		__mmask16 isCoincident = _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(length1, length0)), epsilon, _CMP_LE_OQ);
+		isCoincident = _mm512_mask_cmp_ps_mask(isCoincident, _mm512_abs_ps(differenceX), epsilon, _CMP_LE_OQ);
+		isCoincident = _mm512_mask_cmp_ps_mask(isCoincident, _mm512_abs_ps(differenceY), epsilon, _CMP_LE_OQ);
+		isCoincident = _mm512_mask_cmp_ps_mask(isCoincident, _mm512_abs_ps(differenceZ), epsilon, _CMP_LE_OQ);
+		__mmask16 isTouchingFrom0 = _mm512_cmp_ps_mask(_mm512_sub_ps(lengthSum, differenceMagnitude), epsilon, _CMP_LE_OQ) |
+			_mm512_mask_cmp_ps_mask(is1Shorter, _mm512_abs_ps(_mm512_sub_ps(_mm512_add_ps(length1, differenceMagnitude), length0)), epsilon, _CMP_LE_OQ);
+		__mmask16 isTouchingFrom1 = _mm512_mask_cmp_ps_mask(is0Shorter, _mm512_abs_ps(_mm512_sub_ps(_mm512_add_ps(length0, differenceMagnitude), length1)), epsilon, _CMP_LE_OQ);
+
+		//Coincident spheres
+		__m512 hintX = _mm512_maskz_loadu_ps(pairMask, pairs.hint_x + pairIndex), hintY = _mm512_maskz_loadu_ps(pairMask, pairs.hint_y + pairIndex);
+		__m512 hintZ = _mm512_maskz_loadu_ps(pairMask, pairs.hint_z + pairIndex);
+		__m512 hintMagnitude = _mm512_maskz_sqrt_ps(pairMask, _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(hintX, hintX), _mm512_mul_ps(hintY, hintY)), _mm512_mul_ps(hintZ, hintZ)));
+		__m512 coincidentX = _mm512_add_ps(_mm512_mul_ps(_mm512_div_ps(hintX, hintMagnitude), length0), position0X);
+		__m512 coincidentY = _mm512_add_ps(_mm512_mul_ps(_mm512_div_ps(hintY, hintMagnitude), length0), position0Y);
+		__m512 coincidentZ = _mm512_add_ps(_mm512_mul_ps(_mm512_div_ps(hintZ, hintMagnitude), length0), position0Z);
+
+		//Spheres touching at one point
+		__m512 touchingScale = _mm512_mask_blend_ps(isTouchingFrom1, _mm512_div_ps(length0, differenceMagnitude), _mm512_div_ps(_mm512_mul_ps(minusOne, length1), differenceMagnitude));
+		__m512 touchingX = _mm512_add_ps(_mm512_mul_ps(differenceX, touchingScale), _mm512_mask_blend_ps(isTouchingFrom1, position0X, position1X));
+		__m512 touchingY = _mm512_add_ps(_mm512_mul_ps(differenceY, touchingScale), _mm512_mask_blend_ps(isTouchingFrom1, position0Y, position1Y));
+		__m512 touchingZ = _mm512_add_ps(_mm512_mul_ps(differenceZ, touchingScale), _mm512_mask_blend_ps(isTouchingFrom1, position0Z, position1Z));
+
+		//Spheres meeting in a circle
+		__m512 distanceRatio = _mm512_add_ps(half, _mm512_div_ps(_mm512_sub_ps(_mm512_mul_ps(length0, length0), _mm512_mul_ps(length1, length1)),
+			_mm512_mul_ps(_mm512_mul_ps(two, differenceMagnitude), differenceMagnitude)));
+		__m512 centerDistance = _mm512_mul_ps(distanceRatio, differenceMagnitude);
+		__m512 circleRadius = _mm512_maskz_sqrt_ps(pairMask, _mm512_sub_ps(_mm512_mul_ps(length0, length0), _mm512_mul_ps(_mm512_mul_ps(centerDistance, distanceRatio), differenceMagnitude)));
+		__m512 normalX = _mm512_div_ps(differenceX, differenceMagnitude), normalY = _mm512_div_ps(differenceY, differenceMagnitude), normalZ = _mm512_div_ps(differenceZ, differenceMagnitude);
+		__mmask16 isHintAlongNormal = _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(_mm512_mul_ps(normalY, hintZ), _mm512_mul_ps(normalZ, hintY))), epsilon, _CMP_LE_OQ);
+		isHintAlongNormal = _mm512_mask_cmp_ps_mask(isHintAlongNormal, _mm512_abs_ps(_mm512_sub_ps(_mm512_mul_ps(normalZ, hintX), _mm512_mul_ps(normalX, hintZ))), epsilon, _CMP_LE_OQ);
+		isHintAlongNormal = _mm512_mask_cmp_ps_mask(isHintAlongNormal, _mm512_abs_ps(_mm512_sub_ps(_mm512_mul_ps(normalX, hintY), _mm512_mul_ps(normalY, hintX))), epsilon, _CMP_LE_OQ);
+		hintX = _mm512_mask_add_ps(hintX, isHintAlongNormal, one, hintX);
+		hintY = _mm512_mask_add_ps(hintY, isHintAlongNormal, zero, hintY);
+		hintZ = _mm512_mask_add_ps(hintZ, isHintAlongNormal, zero, hintZ);
+		__m512 normalHintDot = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(normalX, hintX), _mm512_mul_ps(normalY, hintY)), _mm512_mul_ps(normalZ, hintZ));
+		__m512 planeX = _mm512_sub_ps(hintX, _mm512_mul_ps(normalX, normalHintDot));
+		__m512 planeY = _mm512_sub_ps(hintY, _mm512_mul_ps(normalY, normalHintDot));
+		__m512 planeZ = _mm512_sub_ps(hintZ, _mm512_mul_ps(normalZ, normalHintDot));
+		__m512 planeMagnitude = _mm512_maskz_sqrt_ps(pairMask, _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(planeX, planeX), _mm512_mul_ps(planeY, planeY)), _mm512_mul_ps(planeZ, planeZ)));
+		__m512 circleX = _mm512_add_ps(_mm512_mul_ps(_mm512_div_ps(planeX, planeMagnitude), circleRadius), _mm512_add_ps(_mm512_mul_ps(differenceX, distanceRatio), position0X));
+		__m512 circleY = _mm512_add_ps(_mm512_mul_ps(_mm512_div_ps(planeY, planeMagnitude), circleRadius), _mm512_add_ps(_mm512_mul_ps(differenceY, distanceRatio), position0Y));
+		__m512 circleZ = _mm512_add_ps(_mm512_mul_ps(_mm512_div_ps(planeZ, planeMagnitude), circleRadius), _mm512_add_ps(_mm512_mul_ps(differenceZ, distanceRatio), position0Z));
+
+		__mmask16 hasEnd = ~(isDisjoint | isEnclosedIn0 | isEnclosedIn1);
+		__mmask16 useTouching = isTouchingFrom0 | isTouchingFrom1;
+		__m512 resultX = _mm512_mask_blend_ps(isCoincident, _mm512_mask_blend_ps(useTouching, circleX, touchingX), coincidentX);
+		__m512 resultY = _mm512_mask_blend_ps(isCoincident, _mm512_mask_blend_ps(useTouching, circleY, touchingY), coincidentY);
+		__m512 resultZ = _mm512_mask_blend_ps(isCoincident, _mm512_mask_blend_ps(useTouching, circleZ, touchingZ), coincidentZ);
+		_mm512_mask_storeu_ps(results.common_end_x + pairIndex, pairMask, _mm512_maskz_mov_ps(hasEnd, resultX));
+		_mm512_mask_storeu_ps(results.common_end_y + pairIndex, pairMask, _mm512_maskz_mov_ps(hasEnd, resultY));
+		_mm512_mask_storeu_ps(results.common_end_z + pairIndex, pairMask, _mm512_maskz_mov_ps(hasEnd, resultZ));
+		_mm512_mask_cvtepi32_storeu_epi8(results.has_common_end + pairIndex, pairMask, _mm512_maskz_set1_epi32(hasEnd, 1));
+	}
+}
+#endif
+
+typedef void (*line_segment_batch_kernel)(const line_segment_pair_batch &pairs, line_segment_pair_results &results, size_t pair_count);
+
+//Pick the widest kernel the processor supports, once
+static line_segment_batch_kernel lineSegmentBatchKernel()
+{
+	static const line_segment_batch_kernel chosenKernel = [] () -> line_segment_batch_kernel
+	{
+#if ROD_TOUCH_POINT_X86_KERNELS
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx512f"))
+		{
+			return intersectLineSegmentsAvx512;
+		}
+		if(__builtin_cpu_supports("avx2"))
+		{
+			return intersectLineSegmentsAvx2;
+		}
+#endif
+		return intersectLineSegmentsScalar;
+	}();
+	return chosenKernel;
+}
+
+//Same as intersect_line_segments for each of pair_count pairs. Every case is worked out for every pair and the right one picked
+//with conditional selects instead of returning early. On processors with AVX-512 or AVX2 this runs the hand-written kernels
+//above, 16 or 8 pairs at a time; otherwise it runs the plain loop, whose tests are combined with & and | rather than && and ||,
+//which would branch, so the compiler can vectorize it too. That needs -O3 (or -O2 -ftree-vectorize), -fno-math-errno, since
+//otherwise sqrt has to be able to set errno, and -fno-trapping-math, since otherwise a division whose result isn't picked can't
+//be done for every pair; the Build line at the top gives all three, and without them the plain loop is not vectorized
+void intersect_line_segments_batch(
+	const line_segment_pair_batch &pairs,	// origins, lengths and hint directions of the pairs
+	line_segment_pair_results &results,	// receives the common endpoint of each pair and whether it has one
+	size_t pair_count)			// number of pairs
+{
+	lineSegmentBatchKernel()(pairs, results, pair_count);
+}
+
+//A pair of rods, by index, whose reach spheres overlap, so that they may have a common endpoint
+struct rod_pair
+{
+	unsigned int rod_0; //Lower index of the two
+	unsigned int rod_1; //Higher index of the two
+};
+
+//A rod's place in one cell of the broad phase grid
+struct rod_grid_entry
+{
+	int cell_x, cell_y, cell_z;
+	unsigned int rod;
+};
+
+//Broad phase grid over the reach spheres of a set of rods, built by buildRodGrid. Cells are hashed into buckets, and each bucket
+//lists the rods in the cells hashed to it, so a bucket can hold rods of other cells too
+struct rod_grid
+{
+	float cell_size;
+	point3d origin; //Low corner of the lowest cell
+	vector<int> low_cells, high_cells; //Cells at the low and high corners of each rod's bounding box, three coordinates per rod
+	vector<bool> is_oversized; //True for rods left out of the grid
+	vector<unsigned int> oversized_rods; //Rods left out of the grid, in increasing order
+	vector<unsigned int> bucket_starts; //Start of each bucket in entries, plus the end of the last
+	vector<rod_grid_entry> entries; //Entries of each bucket, in increasing order of rod
+};
+
+//Rods whose reach sphere spans more cells than this along any axis are kept out of the grid and tested against every rod, so
+//that one long rod among many short ones doesn't fill thousands of cells
+const int maxGridCellsPerAxis = 4;
+
+//True unless intersect_line_segments would find the reach spheres of the two rods disjoint; this is the same test, so the
+//broad phase never drops a pair the exact solve would accept
+static bool reachSpheresOverlap(point3d position_0, float length_0, point3d position_1, float length_1)
+{
+	const float epsilon = rod_scalar_policy<float>::epsilon; //Same as intersect_line_segments
+	vector3d differenceVector = subtractVectors(position_1, position_0);
+	return (length_0 + length_1) - vectorMagnitude(differenceVector) > -epsilon;
+}
+
+static size_t gridBucket(int cellX, int cellY, int cellZ, size_t bucketMask)
+{
+	return ((unsigned int)cellX * 73856093u ^ (unsigned int)cellY * 19349663u ^ (unsigned int)cellZ * 83492791u) & bucketMask;
+}
+
+//Places each rod's reach sphere, padded by epsilon so no pair is lost to rounding, in every cell its bounding box touches. Cells
+//are twice the average sphere's diameter across, so most spheres touch only a few cells without each cell collecting too many
+//rods, or larger if needed to keep the cell coordinates of far apart rods from overflowing
+static void buildRodGrid(const point3d *positions, const float *lengths, size_t rod_count, rod_grid &grid)
+{
+	const float epsilon = rod_scalar_policy<float>::epsilon; //Same as intersect_line_segments
+	double lengthTotal = 0;
+	point3d lowCorner = {INFINITY, INFINITY, INFINITY}, highCorner = {-INFINITY, -INFINITY, -INFINITY};
+	for(size_t rodIndex = 0; rodIndex < rod_count; rodIndex++)
+	{
+		float reach = lengths[rodIndex] + epsilon;
+		lengthTotal += lengths[rodIndex];
+		lowCorner = {min(lowCorner.x, positions[rodIndex].x - reach), min(lowCorner.y, positions[rodIndex].y - reach), min(lowCorner.z, positions[rodIndex].z - reach)};
+		highCorner = {max(highCorner.x, positions[rodIndex].x + reach), max(highCorner.y, positions[rodIndex].y + reach), max(highCorner.z, positions[rodIndex].z + reach)};
+	}
+	float extent = max(max(highCorner.x - lowCorner.x, highCorner.y - lowCorner.y), highCorner.z - lowCorner.z);
+	grid.cell_size = max(max(float(4 * lengthTotal / max(rod_count, size_t(1))), extent / (1 << 20)), epsilon);
+	grid.origin = lowCorner;
+
+	grid.low_cells.resize(3 * rod_count);
+	grid.high_cells.resize(3 * rod_count);
+	grid.is_oversized.assign(rod_count, false);
+	grid.oversized_rods.clear();
+	size_t entryCount = 0;
+	for(size_t rodIndex = 0; rodIndex < rod_count; rodIndex++)
+	{
+		float reach = lengths[rodIndex] + epsilon;
+		const float rodOrigin[3] = {positions[rodIndex].x - grid.origin.x, positions[rodIndex].y - grid.origin.y, positions[rodIndex].z - grid.origin.z};
+		int *lowCell = &grid.low_cells[3 * rodIndex], *highCell = &grid.high_cells[3 * rodIndex];
+		for(int axis = 0; axis < 3; axis++)
+		{
+			lowCell[axis] = int(floor((rodOrigin[axis] - reach) / grid.cell_size));
+			highCell[axis] = int(floor((rodOrigin[axis] + reach) / grid.cell_size));
+		}
+		if(highCell[0] - lowCell[0] >= maxGridCellsPerAxis || highCell[1] - lowCell[1] >= maxGridCellsPerAxis || highCell[2] - lowCell[2] >= maxGridCellsPerAxis)
+		{
+			grid.is_oversized[rodIndex] = true;
+			grid.oversized_rods.push_back(rodIndex);
+			continue;
+		}
+		entryCount += (highCell[0] - lowCell[0] + 1) * (highCell[1] - lowCell[1] + 1) * (highCell[2] - lowCell[2] + 1);
+	}
+
+	//Counting sort of the entries into buckets; going through the rods in order leaves each bucket in order of rod
+	size_t bucketCount = 1;
+	while(bucketCount < entryCount)
+	{
+		bucketCount *= 2;
+	}
+	grid.bucket_starts.assign(bucketCount + 1, 0);
+	grid.entries.resize(entryCount);
+	for(int pass = 0; pass < 2; pass++)
+	{
+		for(size_t rodIndex = 0; rodIndex < rod_count; rodIndex++)
+		{
+			if(grid.is_oversized[rodIndex])
+			{
+				continue;
+			}
+			const int *lowCell = &grid.low_cells[3 * rodIndex], *highCell = &grid.high_cells[3 * rodIndex];
+			for(int cellX = lowCell[0]; cellX <= highCell[0]; cellX++)
+			{
+				for(int cellY = lowCell[1]; cellY <= highCell[1]; cellY++)
+				{
+					for(int cellZ = lowCell[2]; cellZ <= highCell[2]; cellZ++)
+					{
+						size_t bucket = gridBucket(cellX, cellY, cellZ, bucketCount - 1);
+						if(pass == 0)
+						{
+							grid.bucket_starts[bucket + 1]++;
+						}
+						else
+						{
+							grid.entries[grid.bucket_starts[bucket]++] = {cellX, cellY, cellZ, (unsigned int)rodIndex};
+						}
+					}
+				}
+			}
+		}
+		if(pass == 0) //Turn the counts into starts
+		{
+			for(size_t bucket = 0; bucket < bucketCount; bucket++)
+			{
+				grid.bucket_starts[bucket + 1] += grid.bucket_starts[bucket];
+			}
+		}
+		else //Placing the entries advanced each start to the next bucket's start, so shift them back
+		{
+			for(size_t bucket = bucketCount; bucket > 0; bucket--)
+			{
+				grid.bucket_starts[bucket] = grid.bucket_starts[bucket - 1];
+			}
+			grid.bucket_starts[0] = 0;
+		}
+	}
+}
+
+//Appends the pairs of rod_0 with the higher numbered rods whose reach spheres overlap its own, in order of rod_1. A pair sharing
+//several cells is only compared in the first of them, the one at the low corner of where their boxes overlap, so each pair is
+//found once without having to remove duplicates
+static void findRodCandidates(const rod_grid &grid, const point3d *positions, const float *lengths, size_t rod_count, unsigned int rod_0, vector<rod_pair> &candidates)
+{
+	size_t firstCandidate = candidates.size();
+	if(grid.is_oversized[rod_0])
+	{
+		for(size_t rodIndex = rod_0 + 1; rodIndex < rod_count; rodIndex++)
+		{
+			if(reachSpheresOverlap(positions[rod_0], lengths[rod_0], positions[rodIndex], lengths[rodIndex]))
+			{
+				candidates.push_back({rod_0, (unsigned int)rodIndex});
+			}
+		}
+		return;
+	}
+
+	const int *lowCell = &grid.low_cells[3 * rod_0], *highCell = &grid.high_cells[3 * rod_0];
+	size_t bucketMask = grid.bucket_starts.size() - 2;
+	for(int cellX = lowCell[0]; cellX <= highCell[0]; cellX++)
+	{
+		for(int cellY = lowCell[1]; cellY <= highCell[1]; cellY++)
+		{
+			for(int cellZ = lowCell[2]; cellZ <= highCell[2]; cellZ++)
+			{
+				size_t bucket = gridBucket(cellX, cellY, cellZ, bucketMask);
+				const rod_grid_entry *bucketEnd = grid.entries.data() + grid.bucket_starts[bucket + 1];
+				const rod_grid_entry *laterEntries = upper_bound(grid.entries.data() + grid.bucket_starts[bucket], bucketEnd, rod_0,
+					[] (unsigned int rod, const rod_grid_entry &entry) { return rod < entry.rod; }); //Skip the lower numbered rods
+				for(const rod_grid_entry *entryPointer = laterEntries; entryPointer < bucketEnd; entryPointer++)
+				{
+					const rod_grid_entry &entry = *entryPointer;
+					if(entry.cell_x != cellX || entry.cell_y != cellY || entry.cell_z != cellZ)
+					{
+						continue;
+					}
+					const int *otherLowCell = &grid.low_cells[3 * entry.rod];
+					if(max(lowCell[0], otherLowCell[0]) != cellX || max(lowCell[1], otherLowCell[1]) != cellY || max(lowCell[2], otherLowCell[2]) != cellZ)
+					{
+						continue; //Compared in another cell
+					}
+					if(reachSpheresOverlap(positions[rod_0], lengths[rod_0], positions[entry.rod], lengths[entry.rod]))
+					{
+						candidates.push_back({rod_0, entry.rod});
+					}
+				}
+			}
+		}
+	}
+	for(unsigned int oversizedRod : grid.oversized_rods)
+	{
+		if(oversizedRod > rod_0 && reachSpheresOverlap(positions[rod_0], lengths[rod_0], positions[oversizedRod], lengths[oversizedRod]))
+		{
+			candidates.push_back({rod_0, oversizedRod});
+		}
+	}
+	sort(candidates.begin() + firstCandidate, candidates.end(), [] (const rod_pair &pair0, const rod_pair &pair1) { return pair0.rod_1 < pair1.rod_1; });
+}
+
+//Broad phase for finding every pair of rods with a common endpoint. Each rod can reach anywhere on the sphere of radius length
+//around its origin, so only rods whose spheres overlap need the exact solve with intersect_line_segments. The spheres are placed
+//in a uniform grid, and each rod is only compared with the rods sharing a cell with it, so with rods of similar lengths the time
+//grows with the number of rods rather than with the number of pairs. The pairs come out in order of rod_0, then rod_1
+void find_rod_pair_candidates(
+	const point3d *positions,		// origin of each rod
+	const float *lengths,			// length of each rod
+	size_t rod_count,			// number of rods
+	vector<rod_pair> &candidates)		// receives the pairs of rods whose reach spheres overlap
+{
+	candidates.clear();
+	rod_grid grid;
+	buildRodGrid(positions, lengths, rod_count, grid);
+	for(size_t rodIndex = 0; rodIndex < rod_count; rodIndex++)
+	{
+		findRodCandidates(grid, positions, lengths, rod_count, rodIndex, candidates);
+	}
+}
+
+//A pair of rods with a common endpoint, found by find_touching_rods
+struct rod_touch
+{
+	unsigned int rod_0; //Lower index of the two
+	unsigned int rod_1; //Higher index of the two
+	point3d common_end; //Point where both rods can be oriented to end, as given by intersect_line_segments
+};
+
+//Rods handed to a worker of find_touching_rods at a time; small enough to share the work out evenly, large enough that claiming
+//them costs next to nothing
+const size_t rodsPerTouchChunk = 512;
+
+//Worker of find_touching_rods: claims chunks of rods until there are none left, and solves the candidate pairs of each one into
+//that chunk's own buffer, so the workers never write to the same place
+static void findTouchingRodChunks(const rod_grid &grid, const point3d *positions, const float *lengths, size_t rod_count, vector3d hint_direction,
+	atomic<size_t> &nextChunk, vector<vector<rod_touch>> &chunkTouches)
+{
+	vector<rod_pair> candidates;
+	for(size_t chunk = nextChunk.fetch_add(1, memory_order_relaxed); chunk < chunkTouches.size(); chunk = nextChunk.fetch_add(1, memory_order_relaxed))
+	{
+		candidates.clear();
+		size_t chunkEnd = min(rod_count, (chunk + 1) * rodsPerTouchChunk);
+		for(size_t rodIndex = chunk * rodsPerTouchChunk; rodIndex < chunkEnd; rodIndex++)
+		{
+			findRodCandidates(grid, positions, lengths, rod_count, rodIndex, candidates);
+		}
+		for(const rod_pair &candidate : candidates)
+		{
+			point3d commonEndPosition;
+			if(intersect_line_segments(positions[candidate.rod_0], lengths[candidate.rod_0], positions[candidate.rod_1], lengths[candidate.rod_1], hint_direction, &commonEndPosition))
+			{
+				chunkTouches[chunk].push_back({candidate.rod_0, candidate.rod_1, commonEndPosition});
+			}
+		}
+	}
+}
+
+//Finds every pair of rods with a common endpoint. The broad phase grid of find_rod_pair_candidates is built once and shared, and
+//the rods are split into chunks that worker threads claim one at a time, each finding and solving the pairs whose lower numbered
+//rod is in the chunk. Every chunk has its own buffer, and the buffers are joined in chunk order once the workers are done, so the
+//results are always in order of rod_0, then rod_1, however many threads there are and whichever thread solved which chunk
+void find_touching_rods(
+	const point3d *positions,		// origin of each rod
+	const float *lengths,			// length of each rod
+	size_t rod_count,			// number of rods
+	vector3d hint_direction,		// in the event a pair has multiple solutions, return the
+						// one furthest in this direction.
+	vector<rod_touch> &touches,		// receives the pairs of rods with a common endpoint
+	int thread_count = 0)			// number of threads to use; 0 uses one per hardware thread
+{
+	touches.clear();
+	rod_grid grid;
+	buildRodGrid(positions, lengths, rod_count, grid);
+
+	vector<vector<rod_touch>> chunkTouches((rod_count + rodsPerTouchChunk - 1) / rodsPerTouchChunk);
+	atomic<size_t> nextChunk(0);
+	if(thread_count <= 0)
+	{
+		thread_count = max(1u, thread::hardware_concurrency());
+	}
+	thread_count = (int)min<size_t>(thread_count, max<size_t>(chunkTouches.size(), 1));
+	vector<thread> workers;
+	for(int workerIndex = 1; workerIndex < thread_count; workerIndex++)
+	{
+		workers.emplace_back(findTouchingRodChunks, cref(grid), positions, lengths, rod_count, hint_direction, ref(nextChunk), ref(chunkTouches));
+	}
+	findTouchingRodChunks(grid, positions, lengths, rod_count, hint_direction, nextChunk, chunkTouches); //The calling thread works too instead of waiting idle
+	for(thread &worker : workers)
+	{
+		worker.join();
+	}
+
+	size_t touchCount = 0;
+	for(const vector<rod_touch> &chunk : chunkTouches)
+	{
+		touchCount += chunk.size();
+	}
+	touches.reserve(touchCount);
+	for(const vector<rod_touch> &chunk : chunkTouches)
+	{
+		touches.insert(touches.end(), chunk.begin(), chunk.end());
+	}
+}
+
+//Build with ROD_TOUCH_POINT_NO_MAIN defined to include this file in another program, such as 3D_Rod_Touch_Point_Test.cpp,
+//without its benchmark and main
+#ifndef ROD_TOUCH_POINT_NO_MAIN
+//Times finding every pair of rod_count random rods with a common endpoint by calling intersect_line_segments on every pair,
+//against doing it on only the pairs found by find_rod_pair_candidates, one at a time and with intersect_line_segments_batch, and
+//against find_touching_rods on thread_count threads, and checks that all of them find the same pairs and the same endpoints, the
+//batch to within epsilon since it isn't the same code as intersect_line_segments. The rods are spread through a cube sized so each rod's
+//reach sphere overlaps a handful of others, however many rods there are
+static bool benchmarkRodPairs(size_t rod_count, int thread_count)
+{
+	mt19937 generator(1);
+	float cubeSize = 2 * cbrt(float(rod_count));
+	uniform_real_distribution<float> positionDistribution(0, cubeSize), lengthDistribution(0.5f, 1.5f);
+	vector<point3d> positions(rod_count);
+	vector<float> lengths(rod_count);
+	for(size_t rodIndex = 0; rodIndex < rod_count; rodIndex++)
+	{
+		positions[rodIndex].x = positionDistribution(generator);
+		positions[rodIndex].y = positionDistribution(generator);
+		positions[rodIndex].z = positionDistribution(generator);
+		lengths[rodIndex] = lengthDistribution(generator);
+	}
+	vector3d hintVector = {0,0,1};
+	point3d commonEndPosition;
+
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	vector<rod_touch> bruteForceTouches;
+	for(unsigned int rod0 = 0; rod0 < rod_count; rod0++)
+	{
+		for(unsigned int rod1 = rod0 + 1; rod1 < rod_count; rod1++)
+		{
+			if(intersect_line_segments(positions[rod0], lengths[rod0], positions[rod1], lengths[rod1], hintVector, &commonEndPosition))
+			{
+				bruteForceTouches.push_back({rod0, rod1, commonEndPosition});
+			}
+		}
+	}
+	double bruteForceSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	startTime = chrono::steady_clock::now();
+	vector<rod_pair> candidates;
+	vector<rod_touch> broadPhaseTouches;
+	find_rod_pair_candidates(positions.data(), lengths.data(), rod_count, candidates);
+	double candidateSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	for(const rod_pair &candidate : candidates)
+	{
+		if(intersect_line_segments(positions[candidate.rod_0], lengths[candidate.rod_0], positions[candidate.rod_1], lengths[candidate.rod_1], hintVector, &commonEndPosition))
+		{
+			broadPhaseTouches.push_back({candidate.rod_0, candidate.rod_1, commonEndPosition});
+		}
+	}
+	double broadPhaseSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	//The same candidates again, gathered into arrays and solved by intersect_line_segments_batch
+	size_t candidateCount = candidates.size();
+	vector<float> position0X(candidateCount), position0Y(candidateCount), position0Z(candidateCount), lengths0(candidateCount);
+	vector<float> position1X(candidateCount), position1Y(candidateCount), position1Z(candidateCount), lengths1(candidateCount);
+	vector<float> hintsX(candidateCount, hintVector.x), hintsY(candidateCount, hintVector.y), hintsZ(candidateCount, hintVector.z);
+	vector<float> commonEndX(candidateCount), commonEndY(candidateCount), commonEndZ(candidateCount);
+	vector<unsigned char> hasCommonEnd(candidateCount);
+	startTime = chrono::steady_clock::now();
+	for(size_t candidateIndex = 0; candidateIndex < candidateCount; candidateIndex++)
+	{
+		const rod_pair &candidate = candidates[candidateIndex];
+		position0X[candidateIndex] = positions[candidate.rod_0].x, position0Y[candidateIndex] = positions[candidate.rod_0].y;
+		position0Z[candidateIndex] = positions[candidate.rod_0].z, lengths0[candidateIndex] = lengths[candidate.rod_0];
+		position1X[candidateIndex] = positions[candidate.rod_1].x, position1Y[candidateIndex] = positions[candidate.rod_1].y;
+		position1Z[candidateIndex] = positions[candidate.rod_1].z, lengths1[candidateIndex] = lengths[candidate.rod_1];
+	}
+	line_segment_pair_batch pairs = {position0X.data(), position0Y.data(), position0Z.data(), lengths0.data(), position1X.data(), position1Y.data(),
+		position1Z.data(), lengths1.data(), hintsX.data(), hintsY.data(), hintsZ.data()};
+	line_segment_pair_results results = {commonEndX.data(), commonEndY.data(), commonEndZ.data(), hasCommonEnd.data()};
+	intersect_line_segments_batch(pairs, results, candidateCount);
+	vector<rod_touch> batchTouches;
+	for(size_t candidateIndex = 0; candidateIndex < candidateCount; candidateIndex++)
+	{
+		if(hasCommonEnd[candidateIndex])
+		{
+			batchTouches.push_back({candidates[candidateIndex].rod_0, candidates[candidateIndex].rod_1, {commonEndX[candidateIndex], commonEndY[candidateIndex], commonEndZ[candidateIndex]}});
+		}
+	}
+	double batchSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	startTime = chrono::steady_clock::now();
+	vector<rod_touch> parallelTouches;
+	find_touching_rods(positions.data(), lengths.data(), rod_count, hintVector, parallelTouches, thread_count);
+	double parallelSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+	auto sameTouches = [] (const vector<rod_touch> &touches0, const vector<rod_touch> &touches1)
+	{
+		return touches0.size() == touches1.size() && equal(touches0.begin(), touches0.end(), touches1.begin(), [] (const rod_touch &touch0, const rod_touch &touch1)
+		{
+			return touch0.rod_0 == touch1.rod_0 && touch0.rod_1 == touch1.rod_1 && memcmp(&touch0.common_end, &touch1.common_end, sizeof(point3d)) == 0;
+		});
+	};
+	const float epsilon = rod_scalar_policy<float>::epsilon;
+	bool sameBatchPairs = batchTouches.size() == bruteForceTouches.size() && equal(batchTouches.begin(), batchTouches.end(), bruteForceTouches.begin(),
+		[epsilon] (const rod_touch &touch0, const rod_touch &touch1)
+	{
+		return touch0.rod_0 == touch1.rod_0 && touch0.rod_1 == touch1.rod_1 && abs(touch0.common_end.x - touch1.common_end.x) <= epsilon
+			&& abs(touch0.common_end.y - touch1.common_end.y) <= epsilon && abs(touch0.common_end.z - touch1.common_end.z) <= epsilon;
+	});
+	bool samePairs = sameTouches(bruteForceTouches, broadPhaseTouches) && sameTouches(bruteForceTouches, parallelTouches) && sameBatchPairs;
+	cout << rod_count << " rods, " << bruteForceTouches.size() << " pairs with a common endpoint" << endl;
+	cout << "Every pair: " << rod_count * (rod_count - 1) / 2 << " solved in " << bruteForceSeconds * 1000 << " ms" << endl;
+	cout << "Broad phase: " << candidates.size() << " candidates found in " << candidateSeconds * 1000 << " ms, solved in "
+		<< (broadPhaseSeconds - candidateSeconds) * 1000 << " ms, " << broadPhaseSeconds * 1000 << " ms in all, "
+		<< bruteForceSeconds / broadPhaseSeconds << " times faster" << endl;
+	cout << "Broad phase candidates through intersect_line_segments_batch: gathered and solved in " << batchSeconds * 1000 << " ms, "
+		<< (broadPhaseSeconds - candidateSeconds) / batchSeconds << " times faster than one at a time" << endl;
+	cout << "find_touching_rods on " << (thread_count > 0 ? thread_count : (int)max(1u, thread::hardware_concurrency())) << " threads: "
+		<< parallelSeconds * 1000 << " ms, " << bruteForceSeconds / parallelSeconds << " times faster" << endl;
+	if(!samePairs)
+	{
+		cout << "The broad phase found different pairs!" << endl;
+	}
+	return samePairs;
+}
+
+int main(int argc, char *argv[])
+{
+	if((argc == 3 || (argc == 5 && strcmp(argv[3], "--threads") == 0)) && strcmp(argv[1], "--benchmark") == 0)
+	{
+		return benchmarkRodPairs(strtoul(argv[2], nullptr, 10), argc == 5 ? atoi(argv[4]) : 0) ? 0 : 1;
+	}
+
 	point3d commonEndPosition;
 	point3d point0 = {0,0,0};
 	float length0 = 2.0f;
@@ -224,3 +1092,4 @@ int main()
     cout << commonEndPosition.y << endl;
 	cout << commonEndPosition.z << endl;
 }
+#endif
@@ -0,0 +1,252 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: 3D Rod Intersection Point Tests
+//Program Description: Checks the batch kernels of 3D_Rod_Touch_Point.cpp against its plain loop, the plain loop
+//against intersect_line_segments, intersect_line_segments with double and fixed point coordinates against float,
+//and conversions to fixed point. Each check prints a line saying whether it passed, and the program exits with 1
+//if any failed.
+//Build: g++ -std=c++17 -O3 -fno-math-errno -fno-trapping-math -pthread 3D_Rod_Touch_Point_Test.cpp -o 3D_Rod_Touch_Point_Test
+//Last Updated: 04/11/21
+//*******************************************************************************************************
+#define ROD_TOUCH_POINT_NO_MAIN
+#include "3D_Rod_Touch_Point.cpp"
+
+//Solves the first pair_count pairs with intersect_line_segments using scalar_type, with every origin moved by offset along each
+//axis, and counts the pairs whose result, moved back, differs from the float result by more than tolerance. With
+//line_pairs_only, the pairs meeting in a circle and the random pairs, every sixth pair from the fifth, are skipped
+template<typename scalar_type>
+static size_t countScalarTypeMismatches(const line_segment_pair_batch &pairs, size_t pair_count, double offset, double tolerance, bool line_pairs_only)
+{
+	size_t mismatchCount = 0;
+	for(size_t pairIndex = 0; pairIndex < pair_count; pairIndex++)
+	{
+		if(line_pairs_only && pairIndex % 6 >= 4)
+		{
+			continue;
+		}
+		point3d position0 = {pairs.position_0_x[pairIndex], pairs.position_0_y[pairIndex], pairs.position_0_z[pairIndex]};
+		point3d position1 = {pairs.position_1_x[pairIndex], pairs.position_1_y[pairIndex], pairs.position_1_z[pairIndex]};
+		vector3d hint = {pairs.hint_x[pairIndex], pairs.hint_y[pairIndex], pairs.hint_z[pairIndex]};
+		point3d expectedEnd;
+		bool expectedHasEnd = intersect_line_segments(position0, pairs.length_0[pairIndex], position1, pairs.length_1[pairIndex], hint, &expectedEnd);
+
+		basic_vector3d<scalar_type> movedPosition0 = {scalar_type(position0.x + offset), scalar_type(position0.y + offset), scalar_type(position0.z + offset)};
+		basic_vector3d<scalar_type> movedPosition1 = {scalar_type(position1.x + offset), scalar_type(position1.y + offset), scalar_type(position1.z + offset)};
+		basic_vector3d<scalar_type> scalarHint = {scalar_type(double(hint.x)), scalar_type(double(hint.y)), scalar_type(double(hint.z))};
+		basic_vector3d<scalar_type> commonEnd;
+		bool hasEnd = intersect_line_segments(movedPosition0, scalar_type(double(pairs.length_0[pairIndex])), movedPosition1,
+			scalar_type(double(pairs.length_1[pairIndex])), scalarHint, &commonEnd);
+		if(hasEnd != expectedHasEnd || (hasEnd && (!(abs(double(commonEnd.x) - offset - expectedEnd.x) <= tolerance)
+			|| !(abs(double(commonEnd.y) - offset - expectedEnd.y) <= tolerance) || !(abs(double(commonEnd.z) - offset - expectedEnd.z) <= tolerance))))
+		{
+			mismatchCount++;
+		}
+	}
+	return mismatchCount;
+}
+
+//Runs the plain loop, intersectLineSegmentsScalar, over a set of pairs and checks each result against intersect_line_segments to
+//within epsilon, then runs every batch kernel the processor supports over the same pairs and checks that its results are
+//identical to the plain loop's, bit for bit. Every sixth pair is random and the rest are the special cases: coincident rods, rods
+//touching end to end, a rod enclosed by another touching it from inside, an enclosed rod that can't touch, and a hint along the
+//circle's normal. Each kernel is run on every pair count up to 48 and on the whole set, so every tail an 8 or 16 wide kernel can
+//leave over is covered, and must not write past the last pair. The same pairs are then solved by intersect_line_segments with
+//double and fixed16_16 coordinates, in place and moved far from the origin, and compared with the float results
+static bool checkLineSegmentKernels()
+{
+	const size_t poolSize = 1003, maxPairCount = 48;
+	mt19937 generator(2);
+	uniform_real_distribution<float> positionDistribution(0, 4), lengthDistribution(0.5f, 2.5f), unitDistribution(-1, 1);
+	vector<float> position0X(poolSize), position0Y(poolSize), position0Z(poolSize), lengths0(poolSize);
+	vector<float> position1X(poolSize), position1Y(poolSize), position1Z(poolSize), lengths1(poolSize);
+	vector<float> hintsX(poolSize), hintsY(poolSize), hintsZ(poolSize);
+	for(size_t pairIndex = 0; pairIndex < poolSize; pairIndex++)
+	{
+		point3d position0 = {positionDistribution(generator), positionDistribution(generator), positionDistribution(generator)};
+		float length0 = lengthDistribution(generator), length1 = lengthDistribution(generator);
+		vector3d direction, hint = {unitDistribution(generator), unitDistribution(generator), unitDistribution(generator)};
+		do //A random direction well away from the x axis, since a hint along the normal is nudged along x
+		{
+			direction = {unitDistribution(generator), unitDistribution(generator), unitDistribution(generator)};
+		} while(dotProduct(direction, direction) < 0.01f || abs(direction.x) > 0.5f);
+		direction = normalizeVector(direction);
+		float distance = positionDistribution(generator);
+		switch(pairIndex % 6)
+		{
+		case 0: //Coincident
+			length1 = length0;
+			distance = 0;
+			break;
+		case 1: //Touching end to end
+			distance = length0 + length1;
+			break;
+		case 2: //Enclosed, touching from inside
+			length0 = length1 + 1;
+			distance = length0 - length1;
+			break;
+		case 3: //Enclosed, no common endpoint
+			length0 = length1 + 1;
+			distance = (length0 - length1) / 2;
+			break;
+		case 4: //Meeting in a circle, with the hint along its normal
+			distance = (length0 + length1) / 2;
+			hint = scalarMultiply(pairIndex % 12 == 4 ? 2.0f : -0.5f, direction);
+			break;
+		}
+		vector3d offset = scalarMultiply(distance, direction);
+		point3d position1 = addVectors(position0, offset);
+		position0X[pairIndex] = position0.x, position0Y[pairIndex] = position0.y, position0Z[pairIndex] = position0.z, lengths0[pairIndex] = length0;
+		position1X[pairIndex] = position1.x, position1Y[pairIndex] = position1.y, position1Z[pairIndex] = position1.z, lengths1[pairIndex] = length1;
+		hintsX[pairIndex] = hint.x, hintsY[pairIndex] = hint.y, hintsZ[pairIndex] = hint.z;
+	}
+	line_segment_pair_batch pairs = {position0X.data(), position0Y.data(), position0Z.data(), lengths0.data(), position1X.data(), position1Y.data(),
+		position1Z.data(), lengths1.data(), hintsX.data(), hintsY.data(), hintsZ.data()};
+
+	const float epsilon = rod_scalar_policy<float>::epsilon, unwritten = -12345.0f; //Results past the last pair must keep this value
+	bool allMatch = true;
+
+	//The plain loop over every pair, against intersect_line_segments
+	vector<float> expectedEndX(poolSize), expectedEndY(poolSize), expectedEndZ(poolSize);
+	vector<unsigned char> expectedHasEnd(poolSize);
+	line_segment_pair_results expectedResults = {expectedEndX.data(), expectedEndY.data(), expectedEndZ.data(), expectedHasEnd.data()};
+	intersectLineSegmentsScalar(pairs, expectedResults, poolSize);
+	size_t mismatchCount = 0;
+	for(size_t pairIndex = 0; pairIndex < poolSize; pairIndex++)
+	{
+		point3d position0 = {position0X[pairIndex], position0Y[pairIndex], position0Z[pairIndex]};
+		point3d position1 = {position1X[pairIndex], position1Y[pairIndex], position1Z[pairIndex]};
+		vector3d hint = {hintsX[pairIndex], hintsY[pairIndex], hintsZ[pairIndex]};
+		point3d commonEnd = {0,0,0};
+		bool hasEnd = intersect_line_segments(position0, lengths0[pairIndex], position1, lengths1[pairIndex], hint, &commonEnd);
+		if(!hasEnd)
+		{
+			commonEnd = {0,0,0};
+		}
+		if(expectedHasEnd[pairIndex] != hasEnd || !(abs(expectedEndX[pairIndex] - commonEnd.x) <= epsilon)
+			|| !(abs(expectedEndY[pairIndex] - commonEnd.y) <= epsilon) || !(abs(expectedEndZ[pairIndex] - commonEnd.z) <= epsilon))
+		{
+			if(mismatchCount++ == 0)
+			{
+				cout << "Plain loop differs on pair " << pairIndex << ": " << int(expectedHasEnd[pairIndex]) << " (" << expectedEndX[pairIndex] << ", "
+					<< expectedEndY[pairIndex] << ", " << expectedEndZ[pairIndex] << "), intersect_line_segments gives " << hasEnd << " (" << commonEnd.x
+					<< ", " << commonEnd.y << ", " << commonEnd.z << ")!" << endl;
+			}
+		}
+	}
+	cout << "Plain loop: " << (mismatchCount == 0 ? "matches" : "MISMATCHES") << " intersect_line_segments";
+	cout << (mismatchCount == 0 ? "" : " on " + to_string(mismatchCount) + " pairs") << endl;
+	allMatch = allMatch && mismatchCount == 0;
+
+	//Every kernel at every pair count, against the plain loop; the result of a pair doesn't depend on how many pairs there are
+	vector<pair<const char *, line_segment_batch_kernel>> kernels = {{"Plain loop at each pair count", intersectLineSegmentsScalar}};
+#if ROD_TOUCH_POINT_X86_KERNELS
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx2"))
+	{
+		kernels.push_back({"AVX2", intersectLineSegmentsAvx2});
+	}
+	if(__builtin_cpu_supports("avx512f"))
+	{
+		kernels.push_back({"AVX-512", intersectLineSegmentsAvx512});
+	}
+#endif
+
+	for(const pair<const char *, line_segment_batch_kernel> &kernel : kernels)
+	{
+		mismatchCount = 0;
+		for(size_t pairCount = 0; pairCount <= maxPairCount + 1; pairCount++)
+		{
+			if(pairCount > maxPairCount)
+			{
+				pairCount = poolSize;
+			}
+			vector<float> commonEndX(poolSize + 1, unwritten), commonEndY(poolSize + 1, unwritten), commonEndZ(poolSize + 1, unwritten);
+			vector<unsigned char> hasCommonEnd(poolSize + 1, 2);
+			line_segment_pair_results results = {commonEndX.data(), commonEndY.data(), commonEndZ.data(), hasCommonEnd.data()};
+			kernel.second(pairs, results, pairCount);
+			if(commonEndX[pairCount] != unwritten || commonEndY[pairCount] != unwritten || commonEndZ[pairCount] != unwritten || hasCommonEnd[pairCount] != 2)
+			{
+				if(mismatchCount++ == 0)
+				{
+					cout << kernel.first << " wrote past the last of " << pairCount << " pairs!" << endl;
+				}
+			}
+			for(size_t pairIndex = 0; pairIndex < pairCount; pairIndex++)
+			{
+				if(hasCommonEnd[pairIndex] != expectedHasEnd[pairIndex] || memcmp(&commonEndX[pairIndex], &expectedEndX[pairIndex], sizeof(float)) != 0
+					|| memcmp(&commonEndY[pairIndex], &expectedEndY[pairIndex], sizeof(float)) != 0 || memcmp(&commonEndZ[pairIndex], &expectedEndZ[pairIndex], sizeof(float)) != 0)
+				{
+					if(mismatchCount++ == 0)
+					{
+						cout << kernel.first << " differs on pair " << pairIndex << " of " << pairCount << ": " << int(hasCommonEnd[pairIndex]) << " (" << commonEndX[pairIndex]
+							<< ", " << commonEndY[pairIndex] << ", " << commonEndZ[pairIndex] << "), plain loop gives " << int(expectedHasEnd[pairIndex]) << " ("
+							<< expectedEndX[pairIndex] << ", " << expectedEndY[pairIndex] << ", " << expectedEndZ[pairIndex] << ")!" << endl;
+					}
+				}
+			}
+		}
+		cout << kernel.first << ": " << (mismatchCount == 0 ? "identical to" : "DIFFERS FROM") << " the plain loop";
+		cout << (mismatchCount == 0 ? "" : " on " + to_string(mismatchCount) + " pairs") << endl;
+		allMatch = allMatch && mismatchCount == 0;
+	}
+
+	//Fixed point rounds every step to 1/65536, which adds up to about epsilon, and can only be moved as far as its range allows.
+	//fixed8_8 rounds to 1/256, a few of its own epsilons off along the line between the origins; where rods meet in a circle
+	//its radius comes from the difference of two nearly equal squares, which 8 fraction bits can't place, so those are skipped
+	const double fixed8Tolerance = 4 * double(rod_scalar_policy<fixed8_8>::epsilon);
+	struct
+	{
+		const char *name;
+		size_t (*countMismatches)(const line_segment_pair_batch &pairs, size_t pair_count, double offset, double tolerance, bool line_pairs_only);
+		double offset, tolerance;
+		bool linePairsOnly;
+	} scalarTypeChecks[] = {{"double", countScalarTypeMismatches<double>, 0, epsilon, false},
+		{"double, 1000000 from the origin", countScalarTypeMismatches<double>, 1000000, epsilon, false},
+		{"fixed16_16", countScalarTypeMismatches<fixed16_16>, 0, 2 * epsilon, false},
+		{"fixed16_16, 10000 from the origin", countScalarTypeMismatches<fixed16_16>, 10000, 2 * epsilon, false},
+		{"fixed8_8, pairs meeting on a line", countScalarTypeMismatches<fixed8_8>, 0, fixed8Tolerance, true},
+		{"fixed8_8, pairs meeting on a line 100 from the origin", countScalarTypeMismatches<fixed8_8>, 100, fixed8Tolerance, true}};
+	for(const auto &scalarTypeCheck : scalarTypeChecks)
+	{
+		size_t mismatchCount = scalarTypeCheck.countMismatches(pairs, poolSize, scalarTypeCheck.offset, scalarTypeCheck.tolerance, scalarTypeCheck.linePairsOnly);
+		cout << "intersect_line_segments with " << scalarTypeCheck.name << ": " << (mismatchCount == 0 ? "matches" : "MISMATCHES") << " float";
+		cout << (mismatchCount == 0 ? "" : " on " + to_string(mismatchCount) + " pairs") << endl;
+		allMatch = allMatch && mismatchCount == 0;
+	}
+	return allMatch;
+}
+
+//Values converted from int or double outside the range of a fixed point type saturate at its ends instead of overflowing, and
+//values inside it round to the nearest step
+static bool checkFixedPointConversions()
+{
+	struct
+	{
+		const char *name;
+		long long raw, expectedRaw;
+	} conversions[] = {{"fixed16_16(3)", fixed16_16(3).raw, 3 << 16}, {"fixed16_16(-1.25)", fixed16_16(-1.25).raw, -(5 << 14)},
+		{"fixed16_16(40000)", fixed16_16(40000).raw, INT32_MAX}, {"fixed16_16(-40000)", fixed16_16(-40000).raw, INT32_MIN},
+		{"fixed16_16(1e12)", fixed16_16(1e12).raw, INT32_MAX}, {"fixed16_16(NaN)", fixed16_16(numeric_limits<double>::quiet_NaN()).raw, 0},
+		{"fixed8_8(100)", fixed8_8(100).raw, 100 << 8}, {"fixed8_8(0.3)", fixed8_8(0.3).raw, 77},
+		{"fixed8_8(200)", fixed8_8(200).raw, INT16_MAX}, {"fixed8_8(-1000000000)", fixed8_8(-1000000000).raw, INT16_MIN},
+		{"fixed8_8(-128.5)", fixed8_8(-128.5).raw, INT16_MIN}};
+	bool allMatch = true;
+	for(const auto &conversion : conversions)
+	{
+		if(conversion.raw != conversion.expectedRaw)
+		{
+			cout << conversion.name << " has raw value " << conversion.raw << ", expected " << conversion.expectedRaw << "!" << endl;
+			allMatch = false;
+		}
+	}
+	cout << "Fixed point conversions: " << (allMatch ? "passed" : "FAILED") << endl;
+	return allMatch;
+}
+
+int main()
+{
+	bool allPassed = checkLineSegmentKernels();
+	allPassed = checkFixedPointConversions() && allPassed;
+	cout << (allPassed ? "All checks passed" : "SOME CHECKS FAILED") << endl;
+	return allPassed ? 0 : 1;
+}
@@ -0,0 +1,379 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Solver Benchmark
+//Program Description: Google Benchmark suite for c_boggle. Boards are generated from a fixed seed with
+//English letter frequencies, so every run solves the same boards, and are solved against a large synthetic
+//dictionary, or against a real word list with one word per line if BOGGLE_WORD_LIST names one. Reports
+//boards per second, words found per board and heap allocations per solve, for single boards of several
+//sizes, for scores and paths, for batches, and for changing single cells of a board kept with set_board.
+//Build: g++ -std=c++17 -O2 -pthread Boggle_Benchmark.cpp Boggle_Solver.cpp -lbenchmark -o Boggle_Benchmark
+//Adding -DBOGGLE_SOLVER_STATS=1 also reports search nodes per board and the time per node
+//To catch regressions, save a run with --benchmark_out=before.json --benchmark_out_format=json and compare
+//it to a later one with Google Benchmark's tools/compare.py benchmarks before.json after.json
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Solver.h"
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <atomic>
+#include <thread>
+
+//Every heap allocation made by the process, so a benchmark can report how many allocations a solve makes. Every form of
+//operator new and operator delete except the aligned ones, which keep their library versions, is replaced with one backed
+//by malloc and free, so whichever form allocates a block, the matching delete frees it the same way. They are kept out of
+//line, since GCC otherwise inlines a delete next to the new it pairs with and warns that free is releasing a block from new
+static std::atomic<size_t> allocationCount(0);
+
+static void *countedAllocation(size_t allocationSize) noexcept
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(allocationSize ? allocationSize : 1);
+}
+
+__attribute__((noinline)) void *operator new(size_t allocationSize)
+{
+    if(void *allocation = countedAllocation(allocationSize))
+    {
+        return allocation;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void *operator new[](size_t allocationSize)
+{
+    if(void *allocation = countedAllocation(allocationSize))
+    {
+        return allocation;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void *operator new(size_t allocationSize, const std::nothrow_t &) noexcept
+{
+    return countedAllocation(allocationSize);
+}
+
+__attribute__((noinline)) void *operator new[](size_t allocationSize, const std::nothrow_t &) noexcept
+{
+    return countedAllocation(allocationSize);
+}
+
+__attribute__((noinline)) void operator delete(void *allocation) noexcept
+{
+    std::free(allocation);
+}
+
+__attribute__((noinline)) void operator delete[](void *allocation) noexcept
+{
+    std::free(allocation);
+}
+
+__attribute__((noinline)) void operator delete(void *allocation, size_t) noexcept
+{
+    std::free(allocation);
+}
+
+__attribute__((noinline)) void operator delete[](void *allocation, size_t) noexcept
+{
+    std::free(allocation);
+}
+
+__attribute__((noinline)) void operator delete(void *allocation, const std::nothrow_t &) noexcept
+{
+    std::free(allocation);
+}
+
+__attribute__((noinline)) void operator delete[](void *allocation, const std::nothrow_t &) noexcept
+{
+    std::free(allocation);
+}
+
+//Relative frequency of each letter in English text, in tenths of a percent
+static const int englishLetterWeights[26] = {82, 15, 28, 43, 127, 22, 20, 61, 70, 2, 8, 40, 24, 67, 75, 19, 1, 60, 63, 91, 28, 10, 24, 2, 20, 1};
+
+//Picks letters by English frequency straight from the raw generator output, so the letters for a seed are
+//the same with every standard library
+class c_letter_source
+{
+private:
+    std::mt19937 generator;
+    int cumulativeWeights[26];
+
+public:
+    c_letter_source(unsigned int seed) : generator(seed)
+    {
+        int totalWeight = 0;
+        for(int letterIndex = 0; letterIndex < 26; letterIndex++)
+        {
+            totalWeight += englishLetterWeights[letterIndex];
+            cumulativeWeights[letterIndex] = totalWeight;
+        }
+    }
+
+    char next_letter()
+    {
+        int letterWeight = generator() % cumulativeWeights[25];
+        int letterIndex = 0;
+        while(cumulativeWeights[letterIndex] <= letterWeight)
+        {
+            letterIndex++;
+        }
+        return 'a' + letterIndex;
+    }
+
+    int next_int(int range) {return generator() % range;}
+};
+
+//The dictionary shared by every benchmark, built on first use
+static c_boggle &benchmarkDictionary()
+{
+    static c_boggle dictionary;
+    static bool dictionaryBuilt = [] (c_boggle &newDictionary)
+    {
+        if(const char *wordListPath = std::getenv("BOGGLE_WORD_LIST"))
+        {
+            std::ifstream wordListFile(wordListPath);
+            if(wordListFile && newDictionary.load_legal_words(wordListFile) >= 0)
+            {
+                return true;
+            }
+            std::cout << "Could not read word list " << wordListPath << ", using the synthetic dictionary" << std::endl;
+        }
+
+        //Synthetic dictionary about the size of a tournament word list, with word lengths from 4 to 12 letters;
+        //alternating runs of vowels and consonants keep the prefixes close enough to English that boards have words
+        c_letter_source wordLetters(12345);
+        std::vector<std::string> syntheticWords;
+        for(int wordNumber = 0; wordNumber < 200000; wordNumber++)
+        {
+            int wordLength = 4 + wordLetters.next_int(5) + wordLetters.next_int(5);
+            std::string newWord;
+            int sameKindRun = 0; //Number of vowels or consonants in a row at the end of the word
+            bool lastIsVowel = false;
+            while((int)newWord.size() < wordLength)
+            {
+                char nextLetter = wordLetters.next_letter();
+                bool isVowel = std::strchr("aeiou", nextLetter) != nullptr;
+                if(!newWord.empty() && isVowel == lastIsVowel && sameKindRun == 2) //No runs of three vowels or three consonants
+                {
+                    continue;
+                }
+                sameKindRun = (!newWord.empty() && isVowel == lastIsVowel) ? sameKindRun + 1 : 1;
+                lastIsVowel = isVowel;
+                newWord += nextLetter;
+            }
+            syntheticWords.push_back(newWord);
+        }
+        newDictionary.set_legal_words(syntheticWords);
+        return true;
+    }(dictionary);
+    benchmark::DoNotOptimize(dictionaryBuilt);
+    return dictionary;
+}
+
+//A set of boards of one size generated from a seed that depends only on the size
+static std::vector<std::string> benchmarkBoards(int board_width, int board_height, int board_count)
+{
+    c_letter_source boardLetters(board_width * 1000 + board_height);
+    std::vector<std::string> boards(board_count);
+    for(std::string &board : boards)
+    {
+        for(int currentPosition = 0; currentPosition < board_width * board_height; currentPosition++)
+        {
+            board += boardLetters.next_letter();
+        }
+    }
+    return boards;
+}
+
+//Report the search counters collected over a benchmark, if the solver was built with them
+static void reportSearchCounters(benchmark::State &state, const c_boggle_solve_stats &totalStats)
+{
+#if BOGGLE_SOLVER_STATS
+    double boardsSolved = totalStats.boards_solved ? totalStats.boards_solved : 1;
+    state.counters["nodes"] = benchmark::Counter(totalStats.nodes_visited / boardsSolved);
+    state.counters["prunes"] = benchmark::Counter(totalStats.dead_end_prunes / boardsSolved);
+    state.counters["time_per_node"] = benchmark::Counter(totalStats.nodes_visited, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+#else
+    (void)state;
+    (void)totalStats;
+#endif
+}
+
+//Solve single boards one after another on the calling thread, cycling through a fixed set of boards. With fixed set to 0,
+//boards of 4x4, 5x5 and 6x6 go through the general search instead of the solver specialized for their shape, so each pair of
+//runs measures what the specialized solver gains
+static void BM_SolveBoard(benchmark::State &state)
+{
+    int board_width = state.range(0), board_height = state.range(1);
+    c_boggle &dictionary = benchmarkDictionary();
+    dictionary.set_fixed_size_search(state.range(2) != 0);
+    std::vector<std::string> boards = benchmarkBoards(board_width, board_height, 64);
+    c_boggle_solve_stats boardStats, totalStats;
+    c_boggle_solve_stats *solveStats = BOGGLE_SOLVER_STATS ? &boardStats : nullptr;
+    dictionary.solve_board_word_indexes(board_width, board_height, boards[0].c_str(), solveStats); //Let the solve state and stats reach their working size
+
+    size_t boardIndex = 0, wordsFound = 0, startAllocations = allocationCount.load();
+    for(auto _ : state)
+    {
+        std::vector<int> wordIndexes = dictionary.solve_board_word_indexes(board_width, board_height, boards[boardIndex].c_str(), solveStats);
+        wordsFound += wordIndexes.size();
+        totalStats.boards_solved += boardStats.boards_solved;
+        totalStats.nodes_visited += boardStats.nodes_visited;
+        totalStats.dead_end_prunes += boardStats.dead_end_prunes;
+        benchmark::DoNotOptimize(wordIndexes.data());
+        boardIndex = (boardIndex + 1) % boards.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["words"] = benchmark::Counter(wordsFound, benchmark::Counter::kAvgIterations);
+    state.counters["allocs"] = benchmark::Counter(allocationCount.load() - startAllocations, benchmark::Counter::kAvgIterations);
+    reportSearchCounters(state, totalStats);
+    dictionary.set_fixed_size_search(true); //The dictionary is shared, so leave it as the other benchmarks expect
+}
+BENCHMARK(BM_SolveBoard)->ArgNames({"width", "height", "fixed"})->Args({4, 4, 1})->Args({4, 4, 0})->Args({5, 5, 1})->Args({5, 5, 0})
+    ->Args({10, 10, 1})->Args({100, 100, 1});
+
+//Same as above, but copying out the found words as strings, which is what solve_board returns
+static void BM_SolveBoardStrings(benchmark::State &state)
+{
+    int board_width = state.range(0), board_height = state.range(1);
+    c_boggle &dictionary = benchmarkDictionary();
+    std::vector<std::string> boards = benchmarkBoards(board_width, board_height, 64);
+    dictionary.solve_board(board_width, board_height, boards[0].c_str());
+
+    size_t boardIndex = 0, wordsFound = 0, startAllocations = allocationCount.load();
+    for(auto _ : state)
+    {
+        std::vector<std::string> words = dictionary.solve_board(board_width, board_height, boards[boardIndex].c_str());
+        wordsFound += words.size();
+        benchmark::DoNotOptimize(words.data());
+        boardIndex = (boardIndex + 1) % boards.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["words"] = benchmark::Counter(wordsFound, benchmark::Counter::kAvgIterations);
+    state.counters["allocs"] = benchmark::Counter(allocationCount.load() - startAllocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SolveBoardStrings)->ArgNames({"width", "height"})->Args({4, 4})->Args({10, 10});
+
+//Solve single boards for their total score only, which copies out no words at all
+static void BM_SolveBoardScore(benchmark::State &state)
+{
+    int board_width = state.range(0), board_height = state.range(1);
+    c_boggle &dictionary = benchmarkDictionary();
+    std::vector<std::string> boards = benchmarkBoards(board_width, board_height, 64);
+    dictionary.solve_board_score(board_width, board_height, boards[0].c_str());
+
+    size_t boardIndex = 0, totalScore = 0, startAllocations = allocationCount.load();
+    for(auto _ : state)
+    {
+        totalScore += dictionary.solve_board_score(board_width, board_height, boards[boardIndex].c_str());
+        boardIndex = (boardIndex + 1) % boards.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["score"] = benchmark::Counter(totalScore, benchmark::Counter::kAvgIterations);
+    state.counters["allocs"] = benchmark::Counter(allocationCount.load() - startAllocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SolveBoardScore)->ArgNames({"width", "height"})->Args({4, 4})->Args({10, 10});
+
+//Solve single boards for every word's score and path, reusing the same result storage
+static void BM_SolveBoardScored(benchmark::State &state)
+{
+    int board_width = state.range(0), board_height = state.range(1);
+    c_boggle &dictionary = benchmarkDictionary();
+    std::vector<std::string> boards = benchmarkBoards(board_width, board_height, 64);
+    c_boggle_scored_board scoredBoard;
+    dictionary.solve_board_scored(board_width, board_height, boards[0].c_str(), scoredBoard);
+
+    size_t boardIndex = 0, wordsFound = 0, startAllocations = allocationCount.load();
+    for(auto _ : state)
+    {
+        dictionary.solve_board_scored(board_width, board_height, boards[boardIndex].c_str(), scoredBoard);
+        wordsFound += scoredBoard.words.size();
+        boardIndex = (boardIndex + 1) % boards.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["words"] = benchmark::Counter(wordsFound, benchmark::Counter::kAvgIterations);
+    state.counters["allocs"] = benchmark::Counter(allocationCount.load() - startAllocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SolveBoardScored)->ArgNames({"width", "height"})->Args({4, 4})->Args({10, 10});
+
+//Change one random cell at a time of a board kept with set_board, the way a board generator tries out changes; compare
+//with BM_SolveBoard for the cost of solving the changed board from scratch
+static void BM_UpdateCell(benchmark::State &state)
+{
+    int board_width = state.range(0), board_height = state.range(1);
+    c_boggle &dictionary = benchmarkDictionary();
+    std::vector<std::string> boards = benchmarkBoards(board_width, board_height, 1);
+    dictionary.set_board(board_width, board_height, boards[0].c_str());
+    c_letter_source cellChanges(board_width * board_height);
+
+    size_t startAllocations = allocationCount.load();
+    for(auto _ : state)
+    {
+        char newLetter[2] = {cellChanges.next_letter(), '\0'};
+        dictionary.update_cell(cellChanges.next_int(board_width * board_height), newLetter);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocs"] = benchmark::Counter(allocationCount.load() - startAllocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_UpdateCell)->ArgNames({"width", "height"})->Args({4, 4})->Args({5, 5})->Args({10, 10});
+
+//Solve a batch of boards with solve_boards on the given number of threads, 0 meaning one per hardware thread
+static void BM_SolveBoards(benchmark::State &state)
+{
+    int board_width = state.range(0), board_height = state.range(1), thread_count = state.range(2);
+    c_boggle &dictionary = benchmarkDictionary();
+    std::vector<std::string> boards = benchmarkBoards(board_width, board_height, 256);
+    std::vector<c_boggle_board> batch;
+    for(const std::string &board : boards)
+    {
+        batch.push_back({board_width, board_height, board.c_str()});
+    }
+
+    c_boggle_solve_stats batchStats, totalStats;
+    size_t wordsFound = 0, startAllocations = allocationCount.load();
+    for(auto _ : state)
+    {
+        std::vector<std::vector<std::string>> allResults = dictionary.solve_boards(batch.data(), batch.size(), thread_count, BOGGLE_SOLVER_STATS ? &batchStats : nullptr);
+        totalStats.add(batchStats);
+        for(const std::vector<std::string> &results : allResults)
+        {
+            wordsFound += results.size();
+        }
+        benchmark::DoNotOptimize(allResults.data());
+    }
+    int64_t boardsSolved = state.iterations() * (int64_t)batch.size();
+    state.SetItemsProcessed(boardsSolved);
+    state.counters["words"] = benchmark::Counter(double(wordsFound) / boardsSolved);
+    state.counters["allocs"] = benchmark::Counter(double(allocationCount.load() - startAllocations) / boardsSolved);
+    reportSearchCounters(state, totalStats);
+}
+BENCHMARK(BM_SolveBoards)->ArgNames({"width", "height", "threads"})->Args({4, 4, 1})->Args({4, 4, 0})->Args({5, 5, 1})->Args({5, 5, 0})->UseRealTime();
+
+//Solve one very large board at a time with solve_board_parallel
+static void BM_SolveBoardParallel(benchmark::State &state)
+{
+    int board_width = state.range(0), board_height = state.range(1), thread_count = state.range(2);
+    c_boggle &dictionary = benchmarkDictionary();
+    std::vector<std::string> boards = benchmarkBoards(board_width, board_height, 4);
+
+    size_t boardIndex = 0, wordsFound = 0, startAllocations = allocationCount.load();
+    for(auto _ : state)
+    {
+        std::vector<std::string> words = dictionary.solve_board_parallel(board_width, board_height, boards[boardIndex].c_str(), thread_count);
+        wordsFound += words.size();
+        benchmark::DoNotOptimize(words.data());
+        boardIndex = (boardIndex + 1) % boards.size();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["words"] = benchmark::Counter(wordsFound, benchmark::Counter::kAvgIterations);
+    state.counters["allocs"] = benchmark::Counter(allocationCount.load() - startAllocations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SolveBoardParallel)->ArgNames({"width", "height", "threads"})->Args({100, 100, 0})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
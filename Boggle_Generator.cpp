@@ -0,0 +1,212 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Generator
+//Program Description: Implementation of c_boggle_generator, declared in Boggle_Generator.h
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Generator.h"
+#include <iostream>
+#include <thread>
+
+//Dice of the retail game since 1987, except that the "Qu" face is a plain "q", since each face is a single letter
+static const char *const retailDice[16] = {"aaeegn", "abbjoo", "achops", "affkps", "aoottw", "cimotu", "deilrx", "delrvy",
+                                           "distty", "eeghnw", "eeinsu", "ehrtvw", "eiosst", "elrtty", "himnqu", "hlnnrz"};
+
+c_boggle_generator::c_boggle_generator(const char *dictionary_path, const c_boggle_generator_options &generator_options) : dictionaryPath(dictionary_path), options(generator_options)
+{
+    dice = options.dice;
+    if(dice.empty())
+    {
+        dice.assign(std::begin(retailDice), std::end(retailDice));
+    }
+}
+
+//Shuffle the dice onto the cells and roll them; the raw generator output is used directly, so a seed gives the same boards
+//with every standard library
+void c_boggle_generator::rollBoard(std::mt19937_64 &generator, c_climb_board &climbBoard) const
+{
+    int cellCount = options.board_width * options.board_height;
+    climbBoard.cellDice.resize(cellCount);
+    climbBoard.boardLetters.resize(cellCount);
+    for(int cellPosition = 0; cellPosition < cellCount; cellPosition++)
+    {
+        climbBoard.cellDice[cellPosition] = cellPosition % dice.size();
+    }
+    for(int cellPosition = cellCount - 1; cellPosition > 0; cellPosition--)
+    {
+        std::swap(climbBoard.cellDice[cellPosition], climbBoard.cellDice[generator() % (cellPosition + 1)]);
+    }
+    for(int cellPosition = 0; cellPosition < cellCount; cellPosition++)
+    {
+        const std::string &cellDie = dice[climbBoard.cellDice[cellPosition]];
+        climbBoard.boardLetters[cellPosition] = cellDie[generator() % cellDie.size()];
+    }
+}
+
+int c_boggle_generator::targetDistance(int wordCount) const
+{
+    if(wordCount < options.min_words)
+    {
+        return options.min_words - wordCount;
+    }
+    if(options.max_words > 0 && wordCount > options.max_words)
+    {
+        return wordCount - options.max_words;
+    }
+    return 0;
+}
+
+bool c_boggle_generator::hasLongWord(const c_boggle &boggleSolver) const
+{
+    return options.max_word_letters > 0 && boggleSolver.board_longest_word() > options.max_word_letters;
+}
+
+//Roll candidates until one is worth climbing, then climb: each move rerolls one die or swaps two, and is kept unless it
+//takes the board further from the target. Moves that leave the distance the same are kept too, so the board can wander
+//across a plateau, and the climb gives up after climb_moves moves in a row that don't get any closer
+void c_boggle_generator::runWorker(int workerIndex, c_generation_run &generationRun, c_boggle_generator_stats &workerStats) const
+{
+    c_boggle boggleSolver;
+    if(!boggleSolver.load_dictionary(dictionaryPath.c_str()))
+    {
+        return;
+    }
+    c_boggle::c_solve_workspace workspace; //For the upper bound, which leaves the board kept by set_board alone
+    std::seed_seq workerSeed = {uint32_t(options.seed), uint32_t(options.seed >> 32), uint32_t(workerIndex)};
+    std::mt19937_64 generator(workerSeed);
+    c_climb_board climbBoard;
+    int cellCount = options.board_width * options.board_height;
+    char cellText[2] = {0, 0};
+
+    while(generationRun.boardsClaimed.load(std::memory_order_relaxed) < generationRun.acceptedBoards.size())
+    {
+        if(options.max_candidates > 0 && generationRun.candidatesRolled.fetch_add(1, std::memory_order_relaxed) >= options.max_candidates)
+        {
+            return;
+        }
+        rollBoard(generator, climbBoard);
+        workerStats.candidates++;
+        if(options.bound_path_cells > 0 && options.min_words > 0 &&
+           boggleSolver.word_count_upper_bound(workspace, options.board_width, options.board_height, climbBoard.boardLetters.c_str(), options.bound_path_cells) < options.min_words)
+        {
+            workerStats.bound_rejections++;
+            continue;
+        }
+
+        boggleSolver.set_board(options.board_width, options.board_height, climbBoard.boardLetters.c_str());
+        int boardDistance = targetDistance(boggleSolver.board_word_count());
+        for(int movesSinceProgress = 0; movesSinceProgress < options.climb_moves || boardDistance == 0; movesSinceProgress++)
+        {
+            if(boardDistance == 0)
+            {
+                if(!hasLongWord(boggleSolver))
+                {
+                    size_t boardSlot = generationRun.boardsClaimed.fetch_add(1);
+                    if(boardSlot < generationRun.acceptedBoards.size())
+                    {
+                        generationRun.acceptedBoards[boardSlot] = {climbBoard.boardLetters, boggleSolver.board_word_count(), boggleSolver.board_score()};
+                        workerStats.boards_accepted++;
+                    }
+                    break;
+                }
+                if(movesSinceProgress >= options.climb_moves)
+                {
+                    break;
+                }
+            }
+
+            int firstPosition = generator() % cellCount;
+            int secondPosition = -1;
+            char firstLetter = climbBoard.boardLetters[firstPosition];
+            if(cellCount > 1 && (generator() & 1)) //Swap two dice
+            {
+                secondPosition = (firstPosition + 1 + generator() % (cellCount - 1)) % cellCount;
+                std::swap(climbBoard.cellDice[firstPosition], climbBoard.cellDice[secondPosition]);
+                climbBoard.boardLetters[firstPosition] = climbBoard.boardLetters[secondPosition];
+                climbBoard.boardLetters[secondPosition] = firstLetter;
+                cellText[0] = climbBoard.boardLetters[secondPosition];
+                boggleSolver.update_cell(secondPosition, cellText);
+            }
+            else //Reroll one die
+            {
+                const std::string &cellDie = dice[climbBoard.cellDice[firstPosition]];
+                climbBoard.boardLetters[firstPosition] = cellDie[generator() % cellDie.size()];
+            }
+            cellText[0] = climbBoard.boardLetters[firstPosition];
+            boggleSolver.update_cell(firstPosition, cellText);
+            workerStats.moves++;
+
+            int moveDistance = targetDistance(boggleSolver.board_word_count());
+            if(moveDistance <= boardDistance)
+            {
+                workerStats.moves_kept++;
+                if(moveDistance < boardDistance)
+                {
+                    movesSinceProgress = -1;
+                }
+                boardDistance = moveDistance;
+                continue;
+            }
+            //Undo the move
+            if(secondPosition != -1)
+            {
+                std::swap(climbBoard.cellDice[firstPosition], climbBoard.cellDice[secondPosition]);
+                climbBoard.boardLetters[secondPosition] = climbBoard.boardLetters[firstPosition];
+                cellText[0] = climbBoard.boardLetters[secondPosition];
+                boggleSolver.update_cell(secondPosition, cellText);
+            }
+            climbBoard.boardLetters[firstPosition] = firstLetter;
+            cellText[0] = firstLetter;
+            boggleSolver.update_cell(firstPosition, cellText);
+        }
+    }
+}
+
+std::vector<c_boggle_generated_board> c_boggle_generator::generate(size_t board_count, c_boggle_generator_stats *generator_stats)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if(generator_stats)
+    {
+        *generator_stats = c_boggle_generator_stats();
+    }
+    if(options.board_width <= 0 || options.board_height <= 0 || std::any_of(dice.begin(), dice.end(), [] (const std::string &die) { return die.empty(); }))
+    {
+        std::cout << "Boards need a positive size and dice with at least one face!" << std::endl;
+        return {};
+    }
+    c_boggle dictionaryCheck; //Load the dictionary once here so a bad path is reported once, not by every worker
+    if(!dictionaryCheck.load_dictionary(dictionaryPath.c_str()))
+    {
+        return {};
+    }
+
+    c_generation_run generationRun;
+    generationRun.acceptedBoards.resize(board_count);
+    int thread_count = options.thread_count > 0 ? options.thread_count : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<c_boggle_generator_stats> workerStats(thread_count);
+    std::vector<std::thread> workers;
+    for(int workerIndex = 1; workerIndex < thread_count; workerIndex++)
+    {
+        workers.emplace_back(&c_boggle_generator::runWorker, this, workerIndex, std::ref(generationRun), std::ref(workerStats[workerIndex]));
+    }
+    runWorker(0, generationRun, workerStats[0]); //The calling thread works too instead of waiting idle
+    for(std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    generationRun.acceptedBoards.resize(std::min(board_count, generationRun.boardsClaimed.load()));
+    if(generator_stats)
+    {
+        for(const c_boggle_generator_stats &stats : workerStats)
+        {
+            generator_stats->candidates += stats.candidates;
+            generator_stats->bound_rejections += stats.bound_rejections;
+            generator_stats->moves += stats.moves;
+            generator_stats->moves_kept += stats.moves_kept;
+            generator_stats->boards_accepted += stats.boards_accepted;
+        }
+        generator_stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    return std::move(generationRun.acceptedBoards);
+}
@@ -0,0 +1,105 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Generator
+//Program Description: Declaration of c_boggle_generator, which produces boards meeting a target, such as at
+//least 150 words with none longer than 8 letters, from a compiled dictionary. Candidate boards are rolled
+//from a set of dice; a candidate whose word count upper bound is already below the target is thrown away
+//without being solved, and the rest are improved by hill climbing, rerolling or swapping dice one move at a
+//time and re-scoring only the cells that changed with c_boggle::update_cell. Worker threads each keep their
+//own random generator and their own c_boggle mapping the same dictionary file. Every face is a single letter, so
+//the retail dice used by default have a plain "q" where the physical die has "Qu": words with "qu" need a "u"
+//cell next to the "q", and the boards don't match ones rolled with the real dice. The generator program is in
+//Boggle_Generator_Main.cpp; build it with
+//g++ -std=c++17 -O2 -pthread Boggle_Generator.cpp Boggle_Generator_Main.cpp Boggle_Solver.cpp -o Boggle_Generator
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#ifndef BOGGLE_GENERATOR_H
+#define BOGGLE_GENERATOR_H
+
+#include "Boggle_Solver.h"
+#include <atomic>
+#include <random>
+
+//What to generate, and how hard to try
+struct c_boggle_generator_options
+{
+    int board_width = 4; //Width of the boards
+    int board_height = 4; //Height of the boards
+    std::vector<std::string> dice; //Faces of each die, one letter per face, each a symbol of the dictionary's alphabet; empty for the 16 dice of the retail game, with "q" for "Qu". Boards with more cells reuse the dice in order
+    int min_words = 150; //Fewest words an accepted board can have
+    int max_words = 0; //Most words an accepted board can have; 0 for no limit
+    int max_word_letters = 0; //Longest word an accepted board can have, in letters; 0 for no limit
+    int bound_path_cells = 4; //Path length of the word count upper bound used to throw away candidates; 0 to solve every candidate
+    int climb_moves = 200; //Moves tried on a candidate without getting closer to the target before starting on a new one
+    uint64_t max_candidates = 0; //Candidates to roll before giving up on a target that is too hard to reach; 0 for no limit
+    int thread_count = 0; //Number of worker threads; 0 uses one per hardware thread
+    uint64_t seed = 1; //Seed of the random generators; each worker's is derived from it and its index
+};
+
+//A board accepted by the generator
+struct c_boggle_generated_board
+{
+    std::string board_letters; //board_width*board_height letters in row major order
+    int word_count; //Number of words on the board
+    int total_score; //Total score of the board under standard Boggle scoring
+};
+
+//Counters describing a run of the generator, added up over all workers
+struct c_boggle_generator_stats
+{
+    uint64_t candidates = 0; //Boards rolled from the dice
+    uint64_t bound_rejections = 0; //Candidates thrown away because their upper bound was below min_words
+    uint64_t moves = 0; //Hill climbing moves tried
+    uint64_t moves_kept = 0; //Moves that didn't take the board further from the target, and so were kept
+    uint64_t boards_accepted = 0; //Boards that met the target
+    double seconds = 0; //Time the run took
+
+    double boards_per_second() const //Rate boards were accepted at
+    {
+        return seconds > 0 ? boards_accepted / seconds : 0;
+    }
+};
+
+class c_boggle_generator
+{
+private:
+    //A worker's board while it's being climbed: which die is at each cell, and the face showing
+    struct c_climb_board
+    {
+        std::vector<int> cellDice; //Index into dice of the die at each cell
+        std::string boardLetters; //Letter showing at each cell
+    };
+
+    //Progress of a call to generate, shared by its workers
+    struct c_generation_run
+    {
+        std::atomic<size_t> boardsClaimed{0}; //Slots of acceptedBoards taken by workers, which can run past the number of slots as workers finish
+        std::atomic<uint64_t> candidatesRolled{0}; //Candidates rolled by all workers, for max_candidates
+        std::vector<c_boggle_generated_board> acceptedBoards; //One slot per board asked for
+    };
+
+    std::string dictionaryPath;
+    c_boggle_generator_options options;
+    std::vector<std::string> dice; //Dice in use, the retail set if options.dice is empty
+
+    void rollBoard(std::mt19937_64 &generator, c_climb_board &climbBoard) const; //Places the dice on the cells in a random order and rolls each of them
+    int targetDistance(int wordCount) const; //Returns how many words a board is short of min_words or over max_words, or 0 if it's in range
+    bool hasLongWord(const c_boggle &boggleSolver) const; //Returns true if the board kept by the solver has a word over max_word_letters, without copying out its words
+    void runWorker(int workerIndex, c_generation_run &generationRun, c_boggle_generator_stats &workerStats) const; //Generates boards into the slots of the run until every slot has been claimed or max_candidates is reached
+
+public:
+	// prepare to generate boards against the compiled dictionary at the given path, as written by save_dictionary;
+	// each worker thread maps the file, so they share one copy of it
+	c_boggle_generator(
+		const char *dictionary_path,	// compiled dictionary file
+		const c_boggle_generator_options &generator_options = c_boggle_generator_options()); // target and search settings
+
+	// generate the given number of boards meeting the target, returning them in the order they were accepted; returns
+	// fewer if max_candidates runs out first, and none, with a message, if the dictionary can't be loaded or the
+	// options are invalid
+	std::vector<c_boggle_generated_board> generate(
+		size_t board_count,		// number of boards to generate
+		c_boggle_generator_stats *generator_stats = nullptr); // if not null, receives the counters of the run
+};
+
+#endif
@@ -0,0 +1,96 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Generator
+//Program Description: Generates boards meeting a word count target, as described in Boggle_Generator.h, and
+//prints them one per line with their word counts and scores, followed by the boards accepted per second.
+//Usage: Boggle_Generator <dictionary file> [--boards <count>] [--size <width>x<height>] [--min-words <count>]
+//                        [--max-words <count>] [--max-letters <count>] [--bound-cells <cells>]
+//                        [--climb-moves <count>] [--max-candidates <count>] [--threads <count>] [--seed <seed>]
+//--bound-cells 0 --climb-moves 0 turns off the upper bound and the hill climbing, leaving plain rejection
+//sampling to compare against
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Generator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2 || argv[1][0] == '-')
+    {
+        std::cerr << "Usage: " << argv[0] << " <dictionary file> [--boards <count>] [--size <width>x<height>] [--min-words <count>] [--max-words <count>] [--max-letters <count>]"
+                     " [--bound-cells <cells>] [--climb-moves <count>] [--max-candidates <count>] [--threads <count>] [--seed <seed>]" << std::endl;
+        return 1;
+    }
+    c_boggle_generator_options generatorOptions;
+    size_t boardCount = 10;
+    for(int argIndex = 2; argIndex + 1 < argc; argIndex += 2)
+    {
+        const char *optionValue = argv[argIndex + 1];
+        if(std::strcmp(argv[argIndex], "--boards") == 0)
+        {
+            boardCount = std::strtoull(optionValue, nullptr, 10);
+        }
+        else if(std::strcmp(argv[argIndex], "--size") == 0)
+        {
+            if(std::sscanf(optionValue, "%dx%d", &generatorOptions.board_width, &generatorOptions.board_height) != 2)
+            {
+                std::cerr << "Board size should look like 4x4" << std::endl;
+                return 1;
+            }
+        }
+        else if(std::strcmp(argv[argIndex], "--min-words") == 0)
+        {
+            generatorOptions.min_words = std::atoi(optionValue);
+        }
+        else if(std::strcmp(argv[argIndex], "--max-words") == 0)
+        {
+            generatorOptions.max_words = std::atoi(optionValue);
+        }
+        else if(std::strcmp(argv[argIndex], "--max-letters") == 0)
+        {
+            generatorOptions.max_word_letters = std::atoi(optionValue);
+        }
+        else if(std::strcmp(argv[argIndex], "--bound-cells") == 0)
+        {
+            generatorOptions.bound_path_cells = std::atoi(optionValue);
+        }
+        else if(std::strcmp(argv[argIndex], "--climb-moves") == 0)
+        {
+            generatorOptions.climb_moves = std::atoi(optionValue);
+        }
+        else if(std::strcmp(argv[argIndex], "--max-candidates") == 0)
+        {
+            generatorOptions.max_candidates = std::strtoull(optionValue, nullptr, 10);
+        }
+        else if(std::strcmp(argv[argIndex], "--threads") == 0)
+        {
+            generatorOptions.thread_count = std::atoi(optionValue);
+        }
+        else if(std::strcmp(argv[argIndex], "--seed") == 0)
+        {
+            generatorOptions.seed = std::strtoull(optionValue, nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "Unknown option " << argv[argIndex] << std::endl;
+            return 1;
+        }
+    }
+
+    c_boggle_generator boardGenerator(argv[1], generatorOptions);
+    c_boggle_generator_stats generatorStats;
+    std::vector<c_boggle_generated_board> generatedBoards = boardGenerator.generate(boardCount, &generatorStats);
+    for(const c_boggle_generated_board &generatedBoard : generatedBoards)
+    {
+        std::cout << generatedBoard.board_letters << " " << generatedBoard.word_count << " words, " << generatedBoard.total_score << " points" << std::endl;
+    }
+    std::cerr << generatorStats.boards_accepted << " boards in " << std::fixed << std::setprecision(2) << generatorStats.seconds << " s, "
+              << std::setprecision(1) << generatorStats.boards_per_second() << " per second; " << generatorStats.candidates << " candidates, "
+              << generatorStats.bound_rejections << " rejected by the upper bound, " << generatorStats.moves << " climbing moves, "
+              << generatorStats.moves_kept << " kept" << std::endl;
+    return generatedBoards.size() == boardCount ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Server Load Generator
+//Program Description: Sends random boards to a running Boggle_Server over its Unix domain socket and reports
+//the request rate and the p50, p99 and largest latency seen by the clients, from sending a request to
+//receiving its response. Each connection keeps up to --window requests in flight at once.
+//Usage: Boggle_Load_Generator <socket path> [--connections <count>] [--requests <count per connection>]
+//                             [--size <width>x<height>] [--window <requests>] [--words] [--bad-shapes] [--seed <seed>]
+//--bad-shapes makes every 16th request claim a shape its text can't fill, alternately 30000x30000 and 0 wide, and
+//checks that the server answers exactly those as invalid boards rather than trying to solve them
+//With a socket path of "-", the requests are written to standard output instead, for a server reading its
+//standard input: Boggle_Load_Generator - --requests 10000 | Boggle_Server words.dict > responses
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Server.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//Relative frequency of each letter in English text, in tenths of a percent
+static const int englishLetterWeights[26] = {82, 15, 28, 43, 127, 22, 20, 61, 70, 2, 8, 40, 24, 67, 75, 19, 1, 60, 63, 91, 28, 10, 24, 2, 20, 1};
+
+//Settings of a load test
+struct c_load_options
+{
+    int connection_count = 4;
+    int requests_per_connection = 10000;
+    int board_width = 4;
+    int board_height = 4;
+    int window = 16; //Most requests a connection has sent without yet receiving their responses
+    uint32_t flags = boggle_request_score;
+    bool bad_shapes = false;
+    unsigned int seed = 1;
+};
+
+//Results of the requests sent on one connection
+struct c_connection_results
+{
+    c_latency_histogram latency;
+    uint64_t invalidBoards = 0;
+    uint64_t wordsFound = 0;
+    bool failed = false; //True if the connection ended before every response arrived
+};
+
+//True for the requests that --bad-shapes gives a shape that can't be valid
+static bool isBadShape(const c_load_options &loadOptions, uint32_t requestIndex)
+{
+    return loadOptions.bad_shapes && requestIndex % 16 == 15;
+}
+
+//Builds the request frames for one connection, with boards of letters picked by English frequency
+static std::vector<std::string> buildRequests(const c_load_options &loadOptions, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    int cumulativeWeights[26], totalWeight = 0;
+    for(int letterIndex = 0; letterIndex < 26; letterIndex++)
+    {
+        totalWeight += englishLetterWeights[letterIndex];
+        cumulativeWeights[letterIndex] = totalWeight;
+    }
+    uint32_t lettersLength = loadOptions.board_width * loadOptions.board_height;
+    std::vector<std::string> requests(loadOptions.requests_per_connection);
+    for(uint32_t requestIndex = 0; requestIndex < requests.size(); requestIndex++)
+    {
+        c_boggle_request_header requestHeader = {requestIndex, (uint16_t)loadOptions.board_width, (uint16_t)loadOptions.board_height, loadOptions.flags, lettersLength};
+        if(isBadShape(loadOptions, requestIndex))
+        {
+            requestHeader.board_width = requestIndex / 16 % 2 ? 0 : 30000;
+            requestHeader.board_height = requestIndex / 16 % 2 ? loadOptions.board_height : 30000;
+        }
+        std::string &request = requests[requestIndex];
+        request.assign(reinterpret_cast<const char *>(&requestHeader), sizeof(requestHeader));
+        for(uint32_t cellIndex = 0; cellIndex < lettersLength; cellIndex++)
+        {
+            int letterWeight = generator() % totalWeight;
+            int letterIndex = 0;
+            while(cumulativeWeights[letterIndex] <= letterWeight)
+            {
+                letterIndex++;
+            }
+            request.push_back('a' + letterIndex);
+        }
+    }
+    return requests;
+}
+
+static int connectToServer(const char *socket_path)
+{
+    sockaddr_un socketAddress = {};
+    socketAddress.sun_family = AF_UNIX;
+    std::strncpy(socketAddress.sun_path, socket_path, sizeof(socketAddress.sun_path) - 1);
+    int socketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(socketFd >= 0 && connect(socketFd, reinterpret_cast<sockaddr *>(&socketAddress), sizeof(socketAddress)) != 0)
+    {
+        close(socketFd);
+        socketFd = -1;
+    }
+    return socketFd;
+}
+
+//Sends a connection's requests from one thread and reads the responses on another, keeping the window full
+static void runConnection(int socket_fd, const std::vector<std::string> &requests, int window, c_connection_results &results)
+{
+    std::vector<std::chrono::steady_clock::time_point> sendTimes(requests.size());
+    std::mutex windowMutex;
+    std::condition_variable windowOpen;
+    size_t requestsAnswered = 0;
+    bool receiverDone = false;
+
+    std::thread sender([&] ()
+    {
+        for(size_t requestIndex = 0; requestIndex < requests.size(); requestIndex++)
+        {
+            {
+                std::unique_lock<std::mutex> windowLock(windowMutex);
+                windowOpen.wait(windowLock, [&] { return receiverDone || requestIndex - requestsAnswered < (size_t)window; });
+                if(receiverDone)
+                {
+                    return;
+                }
+                sendTimes[requestIndex] = std::chrono::steady_clock::now();
+            }
+            if(!write_fully(socket_fd, requests[requestIndex].data(), requests[requestIndex].size()))
+            {
+                return;
+            }
+        }
+        shutdown(socket_fd, SHUT_WR); //Lets the server finish with this connection once it has answered everything
+    });
+
+    c_boggle_response_header responseHeader;
+    std::string words;
+    while(requestsAnswered < requests.size() && read_fully(socket_fd, &responseHeader, sizeof(responseHeader)))
+    {
+        words.resize(responseHeader.words_length);
+        if(responseHeader.request_id >= requests.size() || responseHeader.status == boggle_response_bad_request || !read_fully(socket_fd, &words[0], words.size()))
+        {
+            break;
+        }
+        std::chrono::steady_clock::time_point receiveTime = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> windowLock(windowMutex);
+        results.latency.record(std::chrono::duration_cast<std::chrono::microseconds>(receiveTime - sendTimes[responseHeader.request_id]).count());
+        results.invalidBoards += responseHeader.status == boggle_response_invalid_board;
+        results.wordsFound += responseHeader.word_count;
+        requestsAnswered++;
+        windowOpen.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> windowLock(windowMutex);
+        results.failed = requestsAnswered < requests.size();
+        receiverDone = true;
+    }
+    windowOpen.notify_one();
+    sender.join();
+    close(socket_fd);
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <socket path or -> [--connections <count>] [--requests <count per connection>] [--size <width>x<height>] [--window <requests>] [--words] [--bad-shapes] [--seed <seed>]" << std::endl;
+        return 1;
+    }
+    const char *socketPath = argv[1];
+    c_load_options loadOptions;
+    for(int argIndex = 2; argIndex < argc; argIndex++)
+    {
+        bool hasValue = argIndex + 1 < argc;
+        if(std::strcmp(argv[argIndex], "--words") == 0)
+        {
+            loadOptions.flags |= boggle_request_words;
+        }
+        else if(std::strcmp(argv[argIndex], "--bad-shapes") == 0)
+        {
+            loadOptions.bad_shapes = true;
+        }
+        else if(hasValue && std::strcmp(argv[argIndex], "--connections") == 0)
+        {
+            loadOptions.connection_count = std::max(1, std::atoi(argv[++argIndex]));
+        }
+        else if(hasValue && std::strcmp(argv[argIndex], "--requests") == 0)
+        {
+            loadOptions.requests_per_connection = std::max(1, std::atoi(argv[++argIndex]));
+        }
+        else if(hasValue && std::strcmp(argv[argIndex], "--size") == 0 && std::sscanf(argv[argIndex + 1], "%dx%d", &loadOptions.board_width, &loadOptions.board_height) == 2 &&
+            loadOptions.board_width > 0 && loadOptions.board_width <= 65535 && loadOptions.board_height > 0 && loadOptions.board_height <= 65535)
+        {
+            argIndex++;
+        }
+        else if(hasValue && std::strcmp(argv[argIndex], "--window") == 0)
+        {
+            loadOptions.window = std::max(1, std::atoi(argv[++argIndex]));
+        }
+        else if(hasValue && std::strcmp(argv[argIndex], "--seed") == 0)
+        {
+            loadOptions.seed = std::strtoul(argv[++argIndex], nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "Unknown or incomplete option " << argv[argIndex] << std::endl;
+            return 1;
+        }
+    }
+
+    //Build every request up front so that the timed part only sends and receives
+    std::vector<std::vector<std::string>> connectionRequests(loadOptions.connection_count);
+    for(int connectionIndex = 0; connectionIndex < loadOptions.connection_count; connectionIndex++)
+    {
+        connectionRequests[connectionIndex] = buildRequests(loadOptions, loadOptions.seed * 1000 + connectionIndex);
+    }
+
+    if(std::strcmp(socketPath, "-") == 0)
+    {
+        for(const std::vector<std::string> &requests : connectionRequests)
+        {
+            for(const std::string &request : requests)
+            {
+                if(!write_fully(1, request.data(), request.size()))
+                {
+                    return 1;
+                }
+            }
+        }
+        return 0;
+    }
+
+    std::vector<int> socketFds;
+    for(int connectionIndex = 0; connectionIndex < loadOptions.connection_count; connectionIndex++)
+    {
+        int socketFd = connectToServer(socketPath);
+        if(socketFd < 0)
+        {
+            std::cerr << "Could not connect to " << socketPath << ": " << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        socketFds.push_back(socketFd);
+    }
+
+    std::vector<c_connection_results> connectionResults(loadOptions.connection_count);
+    std::vector<std::thread> connectionThreads;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for(int connectionIndex = 0; connectionIndex < loadOptions.connection_count; connectionIndex++)
+    {
+        connectionThreads.emplace_back(runConnection, socketFds[connectionIndex], std::cref(connectionRequests[connectionIndex]), loadOptions.window, std::ref(connectionResults[connectionIndex]));
+    }
+    for(std::thread &connectionThread : connectionThreads)
+    {
+        connectionThread.join();
+    }
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    c_latency_histogram totalLatency;
+    uint64_t invalidBoards = 0, wordsFound = 0;
+    int failedConnections = 0;
+    for(const c_connection_results &results : connectionResults)
+    {
+        totalLatency.add(results.latency);
+        invalidBoards += results.invalidBoards;
+        wordsFound += results.wordsFound;
+        failedConnections += results.failed;
+    }
+    std::cout << loadOptions.connection_count << " connections of " << loadOptions.board_width << "x" << loadOptions.board_height << " boards, window " << loadOptions.window << ": "
+        << totalLatency.sampleCount << " responses (" << invalidBoards << " invalid), " << std::fixed << std::setprecision(0) << totalLatency.sampleCount / elapsedSeconds << " per second, "
+        << std::setprecision(1) << (totalLatency.sampleCount ? double(wordsFound) / totalLatency.sampleCount : 0.0) << " words per board, latency p50 "
+        << totalLatency.percentile(0.5) << " us, p99 " << totalLatency.percentile(0.99) << " us, max " << totalLatency.maxMicroseconds << " us" << std::endl;
+    if(failedConnections > 0)
+    {
+        std::cout << failedConnections << " connections ended before every response arrived!" << std::endl;
+        return 1;
+    }
+    uint64_t badShapes = 0;
+    for(int requestIndex = 0; requestIndex < loadOptions.requests_per_connection; requestIndex++)
+    {
+        badShapes += isBadShape(loadOptions, requestIndex);
+    }
+    if(invalidBoards != badShapes * loadOptions.connection_count)
+    {
+        std::cout << "Expected " << badShapes * loadOptions.connection_count << " invalid boards!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
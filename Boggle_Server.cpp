@@ -0,0 +1,413 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Server
+//Program Description: Implementation of c_boggle_server, declared in Boggle_Server.h
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Server.h"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+bool read_fully(int fd, void *buffer, size_t length)
+{
+    char *nextByte = static_cast<char *>(buffer);
+    while(length > 0)
+    {
+        ssize_t bytesRead = read(fd, nextByte, length);
+        if(bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(bytesRead <= 0)
+        {
+            return false;
+        }
+        nextByte += bytesRead;
+        length -= bytesRead;
+    }
+    return true;
+}
+
+bool write_fully(int fd, const void *buffer, size_t length)
+{
+    const char *nextByte = static_cast<const char *>(buffer);
+    while(length > 0)
+    {
+        ssize_t bytesWritten = write(fd, nextByte, length);
+        if(bytesWritten < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(bytesWritten <= 0)
+        {
+            return false;
+        }
+        nextByte += bytesWritten;
+        length -= bytesWritten;
+    }
+    return true;
+}
+
+void c_latency_histogram::record(uint64_t microseconds)
+{
+    //The bucket is the position of the highest set bit, split into 8 by the 3 bits below it; latencies under 8 us get a bucket each
+    int bucketIndex = (int)microseconds;
+    if(microseconds >= (1u << subBucketBits))
+    {
+        int highBit = 63 - __builtin_clzll(microseconds);
+        bucketIndex = ((highBit - subBucketBits + 1) << subBucketBits) + (int)((microseconds >> (highBit - subBucketBits)) & ((1 << subBucketBits) - 1));
+    }
+    bucketCounts[bucketIndex]++;
+    sampleCount++;
+    maxMicroseconds = std::max(maxMicroseconds, microseconds);
+}
+
+void c_latency_histogram::add(const c_latency_histogram &other)
+{
+    for(int bucketIndex = 0; bucketIndex < bucketCount; bucketIndex++)
+    {
+        bucketCounts[bucketIndex] += other.bucketCounts[bucketIndex];
+    }
+    sampleCount += other.sampleCount;
+    maxMicroseconds = std::max(maxMicroseconds, other.maxMicroseconds);
+}
+
+uint64_t c_latency_histogram::percentile(double fraction) const
+{
+    uint64_t targetCount = (uint64_t)(fraction * sampleCount + 0.5);
+    uint64_t countSoFar = 0;
+    for(int bucketIndex = 0; bucketIndex < bucketCount; bucketIndex++)
+    {
+        countSoFar += bucketCounts[bucketIndex];
+        if(countSoFar >= targetCount && countSoFar > 0)
+        {
+            if(bucketIndex < (1 << subBucketBits))
+            {
+                return bucketIndex;
+            }
+            int highBit = (bucketIndex >> subBucketBits) + subBucketBits - 1;
+            uint64_t bucketEnd = (uint64_t((1 << subBucketBits) + (bucketIndex & ((1 << subBucketBits) - 1)) + 1) << (highBit - subBucketBits)) - 1;
+            return std::min(bucketEnd, maxMicroseconds);
+        }
+    }
+    return 0;
+}
+
+c_boggle_server::c_connection::~c_connection()
+{
+    if(ownsFds)
+    {
+        close(inputFd);
+        if(outputFd != inputFd)
+        {
+            close(outputFd);
+        }
+    }
+}
+
+c_boggle_server::c_boggle_server(const c_boggle &boggle_solver, const c_boggle_server_options &server_options) : solver(boggle_solver), options(server_options)
+{
+    queue.capacity = std::max<size_t>(1, options.queue_capacity);
+    int workerCount = options.worker_count > 0 ? options.worker_count : std::max(1u, std::thread::hardware_concurrency());
+    for(int workerIndex = 0; workerIndex < workerCount; workerIndex++)
+    {
+        workers.push_back(std::make_unique<c_worker>());
+    }
+    for(std::unique_ptr<c_worker> &worker : workers) //Started once the list is complete, since stats reads all of it
+    {
+        worker->thread = std::thread(&c_boggle_server::runWorker, this, std::ref(*worker));
+    }
+}
+
+c_boggle_server::~c_boggle_server()
+{
+    stop();
+}
+
+bool c_boggle_server::pushRequest(c_request &&request)
+{
+    std::unique_lock<std::mutex> queueLock(queue.queueMutex);
+    queue.notFull.wait(queueLock, [&] { return queue.closed || queue.requests.size() < queue.capacity; });
+    if(queue.closed)
+    {
+        return false;
+    }
+    queue.requests.push_back(std::move(request));
+    queue.maxDepth = std::max(queue.maxDepth, queue.requests.size());
+    queueLock.unlock();
+    queue.notEmpty.notify_one();
+    return true;
+}
+
+//Small boards take a few microseconds to solve, about what it costs to wake a thread, so a worker takes as many waiting
+//requests as fit in one batch; a large board is taken on its own so that it doesn't hold up small ones behind it
+bool c_boggle_server::popBatch(std::vector<c_request> &batch)
+{
+    batch.clear();
+    std::unique_lock<std::mutex> queueLock(queue.queueMutex);
+    queue.notEmpty.wait(queueLock, [&] { return queue.closed || !queue.requests.empty(); });
+    size_t batchLetters = 0;
+    while(!queue.requests.empty() && batch.size() < options.batch_requests)
+    {
+        size_t lettersLength = queue.requests.front().boardLetters.size();
+        if(!batch.empty() && batchLetters + lettersLength > options.batch_letters)
+        {
+            break;
+        }
+        batchLetters += lettersLength;
+        batch.push_back(std::move(queue.requests.front()));
+        queue.requests.pop_front();
+    }
+    queueLock.unlock();
+    if(batch.empty()) //Closed and empty
+    {
+        return false;
+    }
+    queue.notFull.notify_all();
+    return true;
+}
+
+void c_boggle_server::readRequests(const std::shared_ptr<c_connection> &connection)
+{
+    c_request request;
+    while(read_fully(connection->inputFd, &request.header, sizeof(request.header)))
+    {
+        if(request.header.letters_length > options.max_letters_length)
+        {
+            c_boggle_response_header badRequest = {request.header.request_id, boggle_response_bad_request, 0, 0, 0};
+            std::lock_guard<std::mutex> writeLock(connection->writeMutex);
+            write_fully(connection->outputFd, &badRequest, sizeof(badRequest));
+            return;
+        }
+        request.boardLetters.resize(request.header.letters_length);
+        if(!read_fully(connection->inputFd, &request.boardLetters[0], request.header.letters_length))
+        {
+            return;
+        }
+        //Every cell takes at least one byte of text, so a board with more cells than bytes can't be valid; answer it here, without
+        //the solver ever seeing the shape, since a worker would otherwise size its tables to whatever the client asked for
+        uint64_t cellCount = uint64_t(request.header.board_width) * request.header.board_height;
+        if(cellCount == 0 || cellCount > request.header.letters_length)
+        {
+            c_boggle_response_header invalidBoard = {request.header.request_id, boggle_response_invalid_board, 0, 0, 0};
+            std::lock_guard<std::mutex> writeLock(connection->writeMutex);
+            if(!connection->writeFailed && !write_fully(connection->outputFd, &invalidBoard, sizeof(invalidBoard)))
+            {
+                connection->writeFailed = true;
+            }
+            rejectedBoards.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        request.connection = connection;
+        request.receivedTime = std::chrono::steady_clock::now();
+        if(!pushRequest(std::move(request)))
+        {
+            return;
+        }
+        request = c_request();
+    }
+}
+
+void c_boggle_server::answerRequest(c_worker &worker, const c_request &request, std::string &response)
+{
+    const c_boggle_request_header &requestHeader = request.header;
+    bool wantScore = (requestHeader.flags & boggle_request_score) != 0;
+    int boardScore = 0;
+    //A board whose text has a null byte in it would be read only up to there, which can't match its size, so it's rejected like any other bad size
+    bool boardValid = request.boardLetters.find('\0') == std::string::npos &&
+        solver.solve_board_word_indexes(worker.workspace, requestHeader.board_width, requestHeader.board_height, request.boardLetters.c_str(), worker.wordIndexes, wantScore ? &boardScore : nullptr);
+    if(!boardValid)
+    {
+        worker.wordIndexes.clear();
+    }
+
+    c_boggle_response_header responseHeader = {requestHeader.request_id, boardValid ? boggle_response_ok : boggle_response_invalid_board, (uint32_t)worker.wordIndexes.size(), boardScore, 0};
+    size_t headerOffset = response.size();
+    response.append(reinterpret_cast<const char *>(&responseHeader), sizeof(responseHeader));
+    if(requestHeader.flags & boggle_request_words)
+    {
+        for(int wordIndex : worker.wordIndexes)
+        {
+            response.append(solver.legal_word(wordIndex));
+            response.push_back('\n');
+        }
+        responseHeader.words_length = (uint32_t)(response.size() - headerOffset - sizeof(responseHeader));
+        std::memcpy(&response[headerOffset], &responseHeader, sizeof(responseHeader));
+    }
+
+    std::lock_guard<std::mutex> statsLock(worker.statsMutex);
+    worker.stats.requests_served++;
+    worker.stats.invalid_boards += !boardValid;
+    worker.stats.words_found += worker.wordIndexes.size();
+}
+
+void c_boggle_server::runWorker(c_worker &worker)
+{
+    while(popBatch(worker.batch))
+    {
+        //Answer the whole batch, then write each connection's responses at once
+        size_t connectionCount = 0;
+        for(const c_request &request : worker.batch)
+        {
+            size_t responseIndex = 0;
+            while(responseIndex < connectionCount && worker.responses[responseIndex].first != request.connection.get())
+            {
+                responseIndex++;
+            }
+            if(responseIndex == connectionCount)
+            {
+                if(connectionCount == worker.responses.size())
+                {
+                    worker.responses.emplace_back();
+                }
+                worker.responses[responseIndex].first = request.connection.get();
+                worker.responses[responseIndex].second.clear();
+                connectionCount++;
+            }
+            answerRequest(worker, request, worker.responses[responseIndex].second);
+        }
+        for(size_t responseIndex = 0; responseIndex < connectionCount; responseIndex++)
+        {
+            c_connection &connection = *worker.responses[responseIndex].first;
+            const std::string &response = worker.responses[responseIndex].second;
+            std::lock_guard<std::mutex> writeLock(connection.writeMutex);
+            if(!connection.writeFailed && !write_fully(connection.outputFd, response.data(), response.size()))
+            {
+                connection.writeFailed = true; //The client went away; its remaining requests are still solved, but not answered
+            }
+        }
+
+        std::chrono::steady_clock::time_point answeredTime = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> statsLock(worker.statsMutex);
+        worker.stats.batches++;
+        for(const c_request &request : worker.batch)
+        {
+            worker.stats.latency.record(std::chrono::duration_cast<std::chrono::microseconds>(answeredTime - request.receivedTime).count());
+        }
+    }
+}
+
+void c_boggle_server::serve_stream(int input_fd, int output_fd)
+{
+    readRequests(std::make_shared<c_connection>(input_fd, output_fd, false));
+}
+
+bool c_boggle_server::serve_socket(const char *socket_path, const std::atomic<bool> &stop_requested)
+{
+    sockaddr_un socketAddress = {};
+    socketAddress.sun_family = AF_UNIX;
+    if(std::strlen(socket_path) >= sizeof(socketAddress.sun_path))
+    {
+        std::cout << "Socket path " << socket_path << " is too long!" << std::endl;
+        return false;
+    }
+    std::strcpy(socketAddress.sun_path, socket_path);
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listenFd < 0)
+    {
+        std::cout << "Could not create socket!" << std::endl;
+        return false;
+    }
+    unlink(socket_path);
+    if(bind(listenFd, reinterpret_cast<sockaddr *>(&socketAddress), sizeof(socketAddress)) != 0 || listen(listenFd, 64) != 0)
+    {
+        std::cout << "Could not listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        close(listenFd);
+        return false;
+    }
+
+    //Wait for connections a short time at a time, so a stop request is noticed soon after it's made
+    while(!stop_requested)
+    {
+        pollfd listenPoll = {listenFd, POLLIN, 0};
+        if(poll(&listenPoll, 1, 100) <= 0)
+        {
+            continue;
+        }
+        int connectionFd = accept(listenFd, nullptr, nullptr);
+        if(connectionFd < 0)
+        {
+            continue;
+        }
+        std::shared_ptr<c_connection> connection = std::make_shared<c_connection>(connectionFd, connectionFd, true);
+        {
+            std::lock_guard<std::mutex> readerLock(readerMutex);
+            socketConnections.erase(std::remove_if(socketConnections.begin(), socketConnections.end(), [] (const std::weak_ptr<c_connection> &oldConnection) { return oldConnection.expired(); }), socketConnections.end());
+            socketConnections.push_back(connection);
+            activeReaders++;
+        }
+        std::thread([this, connection] ()
+        {
+            readRequests(connection);
+            std::lock_guard<std::mutex> readerLock(readerMutex);
+            activeReaders--;
+            readersDone.notify_all();
+        }).detach();
+    }
+    close(listenFd);
+    unlink(socket_path);
+
+    //Stop the readers; a reader waiting for room in the queue finishes once the workers make some
+    std::unique_lock<std::mutex> readerLock(readerMutex);
+    for(const std::weak_ptr<c_connection> &socketConnection : socketConnections)
+    {
+        if(std::shared_ptr<c_connection> connection = socketConnection.lock())
+        {
+            shutdown(connection->inputFd, SHUT_RD);
+        }
+    }
+    readersDone.wait(readerLock, [&] { return activeReaders == 0; });
+    return true;
+}
+
+void c_boggle_server::stop()
+{
+    {
+        std::lock_guard<std::mutex> queueLock(queue.queueMutex);
+        queue.closed = true;
+    }
+    queue.notEmpty.notify_all();
+    queue.notFull.notify_all();
+    for(std::unique_ptr<c_worker> &worker : workers)
+    {
+        if(worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+c_boggle_server_stats c_boggle_server::stats()
+{
+    c_boggle_server_stats totalStats;
+    for(std::unique_ptr<c_worker> &worker : workers)
+    {
+        std::lock_guard<std::mutex> statsLock(worker->statsMutex);
+        totalStats.requests_served += worker->stats.requests_served;
+        totalStats.invalid_boards += worker->stats.invalid_boards;
+        totalStats.batches += worker->stats.batches;
+        totalStats.words_found += worker->stats.words_found;
+        totalStats.latency.add(worker->stats.latency);
+    }
+    totalStats.invalid_shapes = rejectedBoards.load(std::memory_order_relaxed);
+    totalStats.requests_served += totalStats.invalid_shapes;
+    totalStats.invalid_boards += totalStats.invalid_shapes;
+    std::lock_guard<std::mutex> queueLock(queue.queueMutex);
+    totalStats.max_queue_depth = queue.maxDepth;
+    return totalStats;
+}
+
+void c_boggle_server::print_stats(std::ostream &output, const c_boggle_server_stats &server_stats, double elapsed_seconds)
+{
+    output << server_stats.requests_served << " requests (" << server_stats.invalid_boards << " invalid), "
+        << std::fixed << std::setprecision(0) << (elapsed_seconds > 0 ? server_stats.requests_served / elapsed_seconds : 0.0) << " per second, "
+        << std::setprecision(1) << (server_stats.batches > 0 ? double(server_stats.requests_served - server_stats.invalid_shapes) / server_stats.batches : 0.0) << " per batch, "
+        << "deepest queue " << server_stats.max_queue_depth << ", latency p50 " << server_stats.latency.percentile(0.5) << " us, p99 "
+        << server_stats.latency.percentile(0.99) << " us, max " << server_stats.latency.maxMicroseconds << " us" << std::endl;
+}
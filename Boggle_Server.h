@@ -0,0 +1,206 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Server
+//Program Description: Declaration of c_boggle_server, which serves solve requests for one shared c_boggle
+//dictionary from a pool of worker threads. Requests arrive as binary frames on standard input or on the
+//connections of a Unix domain socket, wait in a bounded queue, and are answered on the same stream; a full
+//queue stops the reading of new requests, so a client sending faster than the workers can solve is slowed
+//down instead of growing the queue. The server program is in Boggle_Server_Main.cpp and a load generator for
+//it in Boggle_Load_Generator.cpp; build them with
+//g++ -std=c++17 -O2 -pthread Boggle_Server.cpp Boggle_Server_Main.cpp Boggle_Solver.cpp -o Boggle_Server
+//g++ -std=c++17 -O2 -pthread Boggle_Server.cpp Boggle_Load_Generator.cpp Boggle_Solver.cpp -o Boggle_Load_Generator
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#ifndef BOGGLE_SERVER_H
+#define BOGGLE_SERVER_H
+
+#include "Boggle_Solver.h"
+#include <atomic>
+#include <condition_variable>
+#include <ostream>
+#include <thread>
+
+//Frames are sent in the byte order of the machine, since both ends of a Unix domain socket or pipe are on the same machine.
+//A request is this header followed by letters_length bytes of board text
+struct c_boggle_request_header
+{
+    uint32_t request_id; //Chosen by the client and copied into the response, since responses can come back in any order
+    uint16_t board_width; //Width of the board
+    uint16_t board_height; //Height of the board
+    uint32_t flags; //Any of the c_boggle_request_flags
+    uint32_t letters_length; //Bytes of board text following the header; board_width*board_height cells in row major order
+};
+
+enum c_boggle_request_flags : uint32_t
+{
+    boggle_request_words = 1, //Send back the text of the words found, not just how many there are
+    boggle_request_score = 2  //Send back the total score of the board
+};
+
+enum c_boggle_response_status : uint32_t
+{
+    boggle_response_ok = 0,
+    boggle_response_invalid_board = 1, //The board text doesn't match its size, or the size has no cells or more cells than bytes of text
+    boggle_response_bad_request = 2    //The request was too large to accept; the server stops reading from the stream after sending this
+};
+
+//A response is this header followed by words_length bytes holding the words found in alphabetical order, each followed by
+//a newline, if the request asked for them
+struct c_boggle_response_header
+{
+    uint32_t request_id; //request_id of the request being answered
+    uint32_t status; //One of the c_boggle_response_status values
+    uint32_t word_count; //Number of words found
+    int32_t total_score; //Total score of the board, if the request asked for it, or 0
+    uint32_t words_length; //Bytes of word text following the header
+};
+
+//Counts of latencies in buckets that grow with the latency, 8 buckets per power of two microseconds, so percentiles are
+//within about 10% of the true value without keeping every sample
+struct c_latency_histogram
+{
+    static const int subBucketBits = 3;
+    static const int bucketCount = 64 << subBucketBits;
+    uint64_t bucketCounts[bucketCount] = {}; //Number of latencies in each bucket
+    uint64_t sampleCount = 0; //Number of latencies recorded
+    uint64_t maxMicroseconds = 0; //Largest latency recorded
+
+    void record(uint64_t microseconds); //Adds a latency
+    void add(const c_latency_histogram &other); //Adds the latencies recorded by other to these
+    uint64_t percentile(double fraction) const; //Latency that fraction of the recorded latencies are at or below, in microseconds, rounded up to the end of its bucket
+};
+
+//Settings of a c_boggle_server
+struct c_boggle_server_options
+{
+    int worker_count = 0; //Number of worker threads; 0 uses one per hardware thread
+    size_t queue_capacity = 1024; //Most requests waiting to be solved before readers stop reading more
+    size_t batch_requests = 32; //Most requests a worker takes from the queue at once
+    size_t batch_letters = 4096; //Most bytes of board text a worker takes from the queue at once, unless a single board is larger
+    uint32_t max_letters_length = 1 << 20; //Largest board text accepted in one request
+};
+
+//Counters describing the requests served so far by a c_boggle_server
+struct c_boggle_server_stats
+{
+    uint64_t requests_served = 0; //Requests answered, including those with invalid boards
+    uint64_t invalid_boards = 0; //Requests whose board was invalid
+    uint64_t invalid_shapes = 0; //Invalid boards answered by a reader without going through the queue, because their shape can't fit their text
+    uint64_t batches = 0; //Times a worker took requests from the queue
+    uint64_t words_found = 0; //Words found over all boards
+    size_t max_queue_depth = 0; //Most requests waiting in the queue at one time
+    c_latency_histogram latency; //Time from a request being read to its response being written, including time in the queue
+};
+
+class c_boggle_server
+{
+private:
+    //A stream requests are read from and responses written to; closed when the last request read from it has been answered
+    struct c_connection
+    {
+        int inputFd;
+        int outputFd;
+        bool ownsFds; //True to close the file descriptors when done with them
+        std::mutex writeMutex; //Held while a response is being written, so responses from different workers don't interleave
+        bool writeFailed = false; //Set once a write fails, so later responses to the same stream are dropped
+
+        c_connection(int input_fd, int output_fd, bool owns_fds) : inputFd(input_fd), outputFd(output_fd), ownsFds(owns_fds) {}
+        ~c_connection();
+    };
+
+    //A request read from a connection and waiting to be solved
+    struct c_request
+    {
+        std::shared_ptr<c_connection> connection; //Where the response goes
+        c_boggle_request_header header;
+        std::string boardLetters; //Board text, with a null terminator for the solver
+        std::chrono::steady_clock::time_point receivedTime; //When the request finished being read
+    };
+
+    //Bounded queue of requests, filled by any number of readers and emptied by any number of workers. Readers wait while
+    //it's full, and workers wait while it's empty; once closed, readers can't add to it and workers empty what's left
+    struct c_request_queue
+    {
+        std::deque<c_request> requests;
+        size_t capacity;
+        size_t maxDepth = 0; //Most requests queued at one time
+        bool closed = false;
+        std::mutex queueMutex;
+        std::condition_variable notFull, notEmpty;
+    };
+
+    //Everything a worker thread owns; the latency and counters are only read under statsMutex, so reports can be made while it runs
+    struct c_worker
+    {
+        std::thread thread;
+        c_boggle::c_solve_workspace workspace; //Scratch space for solving with the shared dictionary
+        std::vector<c_request> batch; //Requests taken from the queue together
+        std::vector<int> wordIndexes; //Words found on the board being answered
+        std::vector<std::pair<c_connection *, std::string>> responses; //Responses to the batch, gathered per connection so each gets a single write
+        std::mutex statsMutex;
+        c_boggle_server_stats stats;
+    };
+
+    const c_boggle &solver; //Dictionary shared by all workers, which only call its const functions
+    c_boggle_server_options options;
+    c_request_queue queue;
+    std::vector<std::unique_ptr<c_worker>> workers;
+    std::atomic<uint64_t> rejectedBoards{0}; //Requests answered as invalid by a reader, because their shape can't fit their text
+    std::mutex readerMutex; //Guards the reader bookkeeping below
+    std::condition_variable readersDone;
+    int activeReaders = 0; //Connections of serve_socket still being read
+    std::vector<std::weak_ptr<c_connection>> socketConnections; //Connections accepted by serve_socket, so they can be shut down when it stops
+
+    bool pushRequest(c_request &&request); //Waits for room in the queue and adds the request; returns false if the queue is closed
+    bool popBatch(std::vector<c_request> &batch); //Waits for requests and takes a batch of them; returns false once the queue is closed and empty
+    void readRequests(const std::shared_ptr<c_connection> &connection); //Reads requests from a connection until it ends or sends a bad request
+    void runWorker(c_worker &worker); //Answers batches of requests until the queue is closed and empty
+    void answerRequest(c_worker &worker, const c_request &request, std::string &response); //Solves one request and appends its response
+
+public:
+	// start the worker threads, which solve against the given dictionary; it must already have its legal words and
+	// must outlive the server
+	c_boggle_server(
+		const c_boggle &boggle_solver,	// dictionary shared by every worker
+		const c_boggle_server_options &server_options = c_boggle_server_options()); // queue, batch and thread settings
+
+	// finishes the requests already read, then stops the worker threads
+	~c_boggle_server();
+
+	// read requests from a pair of file descriptors, such as standard input and output, until the input ends, and answer
+	// them on the output; returns once every request has been read, while answers to the last of them may still be on
+	// their way, which stop makes sure of
+	void serve_stream(
+		int input_fd,			// file descriptor requests are read from
+		int output_fd);			// file descriptor responses are written to
+
+	// listen on a Unix domain socket at the given path, reading requests from every connection on a thread of its own,
+	// until stop_requested becomes true; then stops reading, waits for the connection threads and returns. Returns false
+	// if the socket can't be created
+	bool serve_socket(
+		const char *socket_path,	// path of the socket to create; an existing file there is replaced
+		const std::atomic<bool> &stop_requested); // set by another thread or a signal handler to shut down
+
+	// stop accepting requests, answer every request already queued, and stop the worker threads; done by the destructor
+	// if not called before
+	void stop();
+
+	// returns the counters added up over all workers so far
+	c_boggle_server_stats stats();
+
+	// write a one-line summary of stats: requests served, requests per second over the given time, mean batch size,
+	// deepest queue, and p50, p99 and largest latency
+	static void print_stats(
+		std::ostream &output,		// where to write the summary
+		const c_boggle_server_stats &server_stats, // counters to summarize
+		double elapsed_seconds);	// time the counters were collected over, for the request rate
+};
+
+//Reads exactly length bytes from a file descriptor, retrying after signals and short reads; returns false if the stream ends
+//or fails first
+bool read_fully(int fd, void *buffer, size_t length);
+
+//Writes exactly length bytes to a file descriptor, retrying after signals and short writes; returns false if the write fails
+bool write_fully(int fd, const void *buffer, size_t length);
+
+#endif
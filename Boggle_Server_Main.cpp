@@ -0,0 +1,117 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Server
+//Program Description: Serves solve requests against a compiled dictionary, as described in Boggle_Server.h.
+//Usage: Boggle_Server <dictionary file> [--socket <path>] [--threads <count>] [--queue <requests>]
+//                     [--batch <requests>] [--report <seconds>]
+//Without --socket, requests are read from standard input and answered on standard output until the input
+//ends. Statistics, including p50 and p99 latency, are written to standard error every --report seconds and
+//when the server stops: at the end of its input, or for a socket on SIGINT or SIGTERM.
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Server.h"
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static std::atomic<bool> stopRequested(false);
+
+static void requestStop(int)
+{
+    stopRequested = true;
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2 || argv[1][0] == '-')
+    {
+        std::cerr << "Usage: " << argv[0] << " <dictionary file> [--socket <path>] [--threads <count>] [--queue <requests>] [--batch <requests>] [--report <seconds>]" << std::endl;
+        return 1;
+    }
+    const char *socketPath = nullptr;
+    c_boggle_server_options serverOptions;
+    int reportSeconds = 0;
+    for(int argIndex = 2; argIndex + 1 < argc; argIndex += 2)
+    {
+        if(std::strcmp(argv[argIndex], "--socket") == 0)
+        {
+            socketPath = argv[argIndex + 1];
+        }
+        else if(std::strcmp(argv[argIndex], "--threads") == 0)
+        {
+            serverOptions.worker_count = std::atoi(argv[argIndex + 1]);
+        }
+        else if(std::strcmp(argv[argIndex], "--queue") == 0)
+        {
+            serverOptions.queue_capacity = std::atoi(argv[argIndex + 1]);
+        }
+        else if(std::strcmp(argv[argIndex], "--batch") == 0)
+        {
+            serverOptions.batch_requests = std::max(1, std::atoi(argv[argIndex + 1]));
+        }
+        else if(std::strcmp(argv[argIndex], "--report") == 0)
+        {
+            reportSeconds = std::atoi(argv[argIndex + 1]);
+        }
+        else
+        {
+            std::cerr << "Unknown option " << argv[argIndex] << std::endl;
+            return 1;
+        }
+    }
+
+    c_boggle boggleSolver;
+    if(!boggleSolver.load_dictionary(argv[1]))
+    {
+        return 1;
+    }
+    std::signal(SIGPIPE, SIG_IGN); //A client that goes away shows up as a failed write instead
+    if(socketPath) //Standard input is served until it ends, so there a signal just ends the program
+    {
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    c_boggle_server boggleServer(boggleSolver, serverOptions);
+    auto secondsSinceStart = [&] () { return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count(); };
+
+    std::mutex reportMutex;
+    std::condition_variable reportWake;
+    bool serving = true;
+    std::thread reportThread;
+    if(reportSeconds > 0)
+    {
+        reportThread = std::thread([&] ()
+        {
+            std::unique_lock<std::mutex> reportLock(reportMutex);
+            while(!reportWake.wait_for(reportLock, std::chrono::seconds(reportSeconds), [&] { return !serving; }))
+            {
+                c_boggle_server::print_stats(std::cerr, boggleServer.stats(), secondsSinceStart());
+            }
+        });
+    }
+
+    bool served = true;
+    if(socketPath)
+    {
+        served = boggleServer.serve_socket(socketPath, stopRequested);
+    }
+    else
+    {
+        boggleServer.serve_stream(0, 1); //Invalid boards are answered with boggle_response_invalid_board, so the solver prints nothing into the responses
+    }
+    boggleServer.stop();
+    {
+        std::lock_guard<std::mutex> reportLock(reportMutex);
+        serving = false;
+    }
+    reportWake.notify_all();
+    if(reportThread.joinable())
+    {
+        reportThread.join();
+    }
+    c_boggle_server::print_stats(std::cerr, boggleServer.stats(), secondsSinceStart());
+    return served ? 0 : 1;
+}
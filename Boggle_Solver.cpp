@@ -7,325 +7,1800 @@
 //https://en.wikipedia.org/wiki/Boggle
 //Last Updated: 04/13/21
 //*******************************************************************************************************
+#include "Boggle_Solver.h"
 #include <stdio.h>
-#include <vector>
-#include <string>
+#include <cerrno>
 #include <cstring>
-#include <unordered_map>
+#include <iterator>
 #include <iostream>
+#include <fstream>
+#include <cctype>
+#include <thread>
+#include <atomic>
+#include <limits>
+#include <random>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if BOGGLE_SOLVER_SIMD && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BOGGLE_SOLVER_X86_KERNELS 1
+#else
+#define BOGGLE_SOLVER_X86_KERNELS 0
+#endif
 
-class c_boggle
-{
-private:
-    std::unordered_map<int, std::vector<std::string>> alphabeticalWordContainers; //Hash map to contain sorted lists of legal words, grouped and accessed by first letter
-    std::vector<std::string> resultWordsList; //The list of words that will be built and returned by solve_board
-    std::vector<bool> isLetterUsed; //Vector array that will be the size of the boggle board, which keeps track of which letters have already been used in the current word
-    int checkNextLetter(int currentLetterPosition, int startingLetterValue, std::string &workingWord); //Main function to build word paths
-    int searchForSubstring(int currentLetterPosition, int startingLetterValue, std::string &workingWord); //Searches for a matching substring in the corresponding word container
-    void insertResultWord(std::string resultWord); //Inserts a found solution word in the vector of result words
-    int working_board_width, working_board_height, board_size; //Dimensions of the board being solved
-    const char *working_board_letters; //Array of characters that make up the current board
-
-public:
-	// prior to solving any board, configure the legal words
-	void set_legal_words(
-		const std::vector<std::string> &all_words); // alphabetically-sorted array of legal words
-
-	// find all words on the specified board, returning a list of them
-	std::vector<std::string> solve_board(
-		int board_width,		// width of the board, e.g. 4 for a retail Boggle game
-		int board_height,		// height of the board, e.g. 4 for a retail Boggle game
-		const char *board_letters);	// board_width*board_height characters in row major order
+//Board reading kernels, used when every symbol of the alphabet is a single letter, symbol i being 'a' + i, so that every byte
+//of a board is one cell. convertLetterCells turns bytes into symbol codes, reading 'A' to 'Z' the same as 'a' to 'z' and any
+//other ASCII byte as -1; it stops at the first non-ASCII byte, which the caller reads as part of a UTF-8 character, and returns
+//the number of bytes converted. symbolMask returns the set of symbols in a list of cells, ignoring cells of -1.
+struct c_board_kernels
+{
+    size_t (*convertLetterCells)(const char *boardText, int8_t *cellSymbols, size_t textLength, int symbolCount);
+    uint32_t (*symbolMask)(const int8_t *cellSymbols, size_t cellCount);
 };
 
-//Sort the list of legal words into containers by first letter; NOTE: this assumes the words come in all lowercase already,
-//though it wouldn't be hard to convert them if neccessary
-void c_boggle::set_legal_words(const std::vector<std::string> &all_words)
+static size_t convertLetterCellsScalar(const char *boardText, int8_t *cellSymbols, size_t textLength, int symbolCount)
 {
-    int firstCharValue;
-    int previousFirstCharValue = -117;//Keep track of the previous first character to quickly find if we need a new container
-    for(std::string word : all_words)
+    for(size_t letterIndex = 0; letterIndex < textLength; letterIndex++)
     {
-        firstCharValue = word[0];
-        if(firstCharValue != previousFirstCharValue)//If it is a new first letter, start a new container in the map
+        unsigned char letter = boardText[letterIndex];
+        if(letter >= 0x80)
         {
-            alphabeticalWordContainers[firstCharValue] =  {word};
+            return letterIndex;
         }
-        else
+        int letterSymbol = (letter | 0x20) - 'a'; //Setting bit 5 makes an uppercase letter lowercase, and can't make anything else a letter
+        cellSymbols[letterIndex] = (letterSymbol >= 0 && letterSymbol < symbolCount) ? letterSymbol : -1;
+    }
+    return textLength;
+}
+
+static uint32_t symbolMaskScalar(const int8_t *cellSymbols, size_t cellCount)
+{
+    uint32_t cellMask = 0;
+    for(size_t cellIndex = 0; cellIndex < cellCount; cellIndex++)
+    {
+        if(cellSymbols[cellIndex] >= 0)
         {
-            alphabeticalWordContainers[firstCharValue].push_back(word);//Add the word to the end of it's container
+            cellMask |= uint32_t(1) << cellSymbols[cellIndex];
         }
-        previousFirstCharValue = firstCharValue;
     }
+    return cellMask;
 }
 
-//Insert a result word into the solution list in alphabetical position using binary insertion
-//This causes the vector's storage capacity to be reallocated with each insert; if we had data on
-//the average size this solution list will end up being, we could reserve more space up front to be
-//more memory efficient, and add a constant amount each time the vector filled up to capacity.
-void c_boggle::insertResultWord(std::string resultWord)
+#if BOGGLE_SOLVER_X86_KERNELS
+//Same as convertLetterCellsScalar, 32 bytes at a time; a block with a non-ASCII byte, and the last partial block, are left to the scalar version
+__attribute__((target("avx2")))
+static size_t convertLetterCellsAvx2(const char *boardText, int8_t *cellSymbols, size_t textLength, int symbolCount)
 {
-    int currentSearchIndex = resultWordsList.size() / 2; //Start index for binary search
-    int lowerIndex = 0; //Lower index for binary search
-    int upperIndex = resultWordsList.size(); //Upper index for binary search
-    int comparisonResult; //Result of comparing 2 strings using str.compare
-    bool continueSearch = true;
-
-    while(continueSearch) //Continue looping until the word is inserted
+    const __m256i caseBit = _mm256_set1_epi8(0x20), firstLetter = _mm256_set1_epi8('a');
+    const __m256i symbolLimit = _mm256_set1_epi8(symbolCount), noSymbol = _mm256_set1_epi8(-1);
+    size_t letterIndex = 0;
+    for(; letterIndex + 32 <= textLength; letterIndex += 32)
     {
-        if(resultWordsList.size() == 0) //If this is the first word added to the list, no search needs to be done.
+        __m256i letters = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(boardText + letterIndex));
+        if(_mm256_movemask_epi8(letters) != 0)
         {
-            resultWordsList.insert(resultWordsList.begin(), resultWord);
-            return;
+            break;
         }
+        __m256i letterSymbols = _mm256_sub_epi8(_mm256_or_si256(letters, caseBit), firstLetter);
+        __m256i isSymbol = _mm256_and_si256(_mm256_cmpgt_epi8(letterSymbols, noSymbol), _mm256_cmpgt_epi8(symbolLimit, letterSymbols));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(cellSymbols + letterIndex), _mm256_or_si256(letterSymbols, _mm256_andnot_si256(isSymbol, noSymbol)));
+    }
+    return letterIndex + convertLetterCellsScalar(boardText + letterIndex, cellSymbols + letterIndex, textLength - letterIndex, symbolCount);
+}
 
-        else if(resultWord > resultWordsList[currentSearchIndex]) //Word is alphabetically later than the one at the current index
+//Same as above, 16 bytes at a time
+__attribute__((target("sse4.2")))
+static size_t convertLetterCellsSse42(const char *boardText, int8_t *cellSymbols, size_t textLength, int symbolCount)
+{
+    const __m128i caseBit = _mm_set1_epi8(0x20), firstLetter = _mm_set1_epi8('a');
+    const __m128i symbolLimit = _mm_set1_epi8(symbolCount), noSymbol = _mm_set1_epi8(-1);
+    size_t letterIndex = 0;
+    for(; letterIndex + 16 <= textLength; letterIndex += 16)
+    {
+        __m128i letters = _mm_loadu_si128(reinterpret_cast<const __m128i *>(boardText + letterIndex));
+        if(_mm_movemask_epi8(letters) != 0)
         {
-            if(currentSearchIndex == resultWordsList.size() - 1) //Word being inserted is alphabetically last so far
-            {
-                resultWordsList.push_back(resultWord);
-                return;
-            }
-            else if(resultWord < resultWordsList[currentSearchIndex + 1]) //Found the two words it comes alphabetically between, insert here
-            {
-                resultWordsList.insert(resultWordsList.begin() + currentSearchIndex + 1, resultWord);
-                return;
-            }
-            else
-            {
-                lowerIndex = currentSearchIndex; //Can't be inserted lower than this
-                currentSearchIndex = currentSearchIndex + (((float)upperIndex - currentSearchIndex) / 2); //Get next index location
-            }
+            break;
         }
+        __m128i letterSymbols = _mm_sub_epi8(_mm_or_si128(letters, caseBit), firstLetter);
+        __m128i isSymbol = _mm_and_si128(_mm_cmpgt_epi8(letterSymbols, noSymbol), _mm_cmpgt_epi8(symbolLimit, letterSymbols));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(cellSymbols + letterIndex), _mm_or_si128(letterSymbols, _mm_andnot_si128(isSymbol, noSymbol)));
+    }
+    return letterIndex + convertLetterCellsScalar(boardText + letterIndex, cellSymbols + letterIndex, textLength - letterIndex, symbolCount);
+}
 
-        else //Word must be alphabetically earlier if it is not later since duplicate words are not allowed
+//Same as symbolMaskScalar, 32 cells at a time: each cell is widened to 32 bits and turned into its symbol's bit with a variable
+//shift, which gives 0 for a cell of -1 since the shift count is out of range
+__attribute__((target("avx2")))
+static uint32_t symbolMaskAvx2(const int8_t *cellSymbols, size_t cellCount)
+{
+    const __m256i oneBit = _mm256_set1_epi32(1);
+    __m256i symbolBits = _mm256_setzero_si256();
+    size_t cellIndex = 0;
+    for(; cellIndex + 32 <= cellCount; cellIndex += 32)
+    {
+        __m256i cells = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cellSymbols + cellIndex));
+        for(__m128i cellHalf : {_mm256_castsi256_si128(cells), _mm256_extracti128_si256(cells, 1)})
         {
-            if(currentSearchIndex == 0) //Word being inserted is alphabetically first so far
-            {
-                resultWordsList.insert(resultWordsList.begin(), resultWord);
-                return;
-            }
-            else if(resultWord > resultWordsList[currentSearchIndex - 1]) //Found the two words it comes alphabetically between, insert here
-            {
-                resultWordsList.insert(resultWordsList.begin() + currentSearchIndex, resultWord);
-                return;
-            }
-            else
-            {
-                upperIndex = currentSearchIndex; //Can't be inserted higher than this
-                currentSearchIndex = currentSearchIndex - (((float)upperIndex - lowerIndex) / 2);
-            }
+            symbolBits = _mm256_or_si256(symbolBits, _mm256_sllv_epi32(oneBit, _mm256_cvtepi8_epi32(cellHalf)));
+            symbolBits = _mm256_or_si256(symbolBits, _mm256_sllv_epi32(oneBit, _mm256_cvtepi8_epi32(_mm_srli_si128(cellHalf, 8))));
         }
     }
+    __m128i maskLanes = _mm_or_si128(_mm256_castsi256_si128(symbolBits), _mm256_extracti128_si256(symbolBits, 1));
+    maskLanes = _mm_or_si128(maskLanes, _mm_shuffle_epi32(maskLanes, 0x4E));
+    maskLanes = _mm_or_si128(maskLanes, _mm_shuffle_epi32(maskLanes, 0xB1));
+    return (uint32_t)_mm_cvtsi128_si32(maskLanes) | symbolMaskScalar(cellSymbols + cellIndex, cellCount - cellIndex);
 }
+#endif
 
-//Helper function to search the word containers for a matching substring to see if we should continue building the current word
-//Uses a binary search to look for words that start with the substring; if a match is found, check if it is a full word
-//from the dictionary; if so, add the word to the solution list. Then, run check next letter to see if there are matches with more letters
-//Returns: 1 if no problems; -1 if word container is emptied
-int c_boggle::searchForSubstring(int currentLetterPosition, int startingLetterValue, std::string &workingWord)
+//Pick the fastest kernels the processor supports, once
+static const c_board_kernels &boardKernels()
 {
-    bool continueSearch = true;
-    std::vector<std::string> *wordContainer = &alphabeticalWordContainers[startingLetterValue];
-    int currentSearchIndex = (*wordContainer).size() / 2; //Get the middle index from the matching word container
-    int upperIndex = (*wordContainer).size() - 1, lowerIndex = 0; //The current highest and lowest indexes
-    int comparisonResult; //Result of comparing 2 strings using str.compare
-    int previousIndex = 0; //Keep track of previous index to see when we run out of words to compare
-    int tempIndex = 0; //Temporary index for working through container looking for an exact match to the substring
+    static const c_board_kernels chosenKernels = [] () -> c_board_kernels
+    {
+#if BOGGLE_SOLVER_X86_KERNELS
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+        {
+            return {convertLetterCellsAvx2, symbolMaskAvx2};
+        }
+        if(__builtin_cpu_supports("sse4.2"))
+        {
+            return {convertLetterCellsSse42, symbolMaskScalar};
+        }
+#endif
+        return {convertLetterCellsScalar, symbolMaskScalar};
+    }();
+    return chosenKernels;
+}
+
+//Lengths up to 100 cover every partial block of the 16 and 32 byte kernels, and the longer ones many whole blocks before the tail
+bool c_boggle::check_board_kernels()
+{
+    std::vector<std::pair<const char *, size_t (*)(const char *, int8_t *, size_t, int)>> convertKernels;
+    std::vector<std::pair<const char *, uint32_t (*)(const int8_t *, size_t)>> maskKernels;
+#if BOGGLE_SOLVER_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse4.2"))
+    {
+        convertKernels.push_back({"SSE4.2 convertLetterCells", convertLetterCellsSse42});
+    }
+    if(__builtin_cpu_supports("avx2"))
+    {
+        convertKernels.push_back({"AVX2 convertLetterCells", convertLetterCellsAvx2});
+        maskKernels.push_back({"AVX2 symbolMask", symbolMaskAvx2});
+    }
+#endif
+    if(convertKernels.empty() && maskKernels.empty())
+    {
+        std::cout << "No board reading kernels to check besides the plain C++ versions" << std::endl;
+        return true;
+    }
 
-    while (continueSearch)
+    std::mt19937 generator(1);
+    std::vector<size_t> textLengths;
+    for(size_t textLength = 0; textLength <= 100; textLength++)
+    {
+        textLengths.push_back(textLength);
+    }
+    textLengths.insert(textLengths.end(), {1000, 1007, 1023, 4096 + 17});
+    const int symbolCounts[] = {26, 20, 5, 1};
+    bool allMatch = true;
+    for(const auto &kernel : convertKernels)
     {
-        comparisonResult = workingWord.compare((*wordContainer)[currentSearchIndex].substr(0,workingWord.length()));
-        if(comparisonResult == 0 || (upperIndex-lowerIndex) < 2) //Substring and a word in the container match, or container is down to 2 words; check for exact match then continue word path
+        size_t mismatchCount = 0;
+        for(size_t textLength : textLengths)
         {
-            (comparisonResult == 0) ? tempIndex = currentSearchIndex : tempIndex = upperIndex; //Set the tempIndex based on which case got us here
-            //Work back in word container to see if there is an exact match for the substring in the dictionary
-            while(workingWord < (*wordContainer)[tempIndex] && tempIndex > 0)
+            for(int trial = 0; trial < 16; trial++)
             {
-                tempIndex--;
+                int symbolCount = symbolCounts[trial % 4];
+                unsigned int nonAsciiOdds = trial < 8 ? 0 : (trial < 12 ? 2 : 20); //Chance in 1000 of each byte being non-ASCII, from none to often
+                std::string boardText(textLength, 'a');
+                for(char &letter : boardText)
+                {
+                    unsigned int byteKind = generator() % 1000;
+                    if(byteKind < nonAsciiOdds)
+                    {
+                        letter = char(0x80 + generator() % 0x80);
+                    }
+                    else if(byteKind < 600)
+                    {
+                        letter = char('a' + generator() % 26);
+                    }
+                    else if(byteKind < 900)
+                    {
+                        letter = char('A' + generator() % 26);
+                    }
+                    else
+                    {
+                        letter = char(1 + generator() % 0x7F); //Any ASCII byte other than nul, so mostly punctuation, digits and control bytes
+                    }
+                }
+                std::vector<int8_t> expectedSymbols(textLength + 1, 99), kernelSymbols(textLength + 1, 99);
+                size_t expectedLength = convertLetterCellsScalar(boardText.c_str(), expectedSymbols.data(), textLength, symbolCount);
+                size_t kernelLength = kernel.second(boardText.c_str(), kernelSymbols.data(), textLength, symbolCount);
+                if(kernelLength != expectedLength || !std::equal(expectedSymbols.begin(), expectedSymbols.begin() + expectedLength, kernelSymbols.begin())
+                    || kernelSymbols[textLength] != 99)
+                {
+                    mismatchCount++;
+                }
             }
-            if(workingWord == (*wordContainer)[tempIndex] && workingWord.length() >= 3) //Indicates an exact match at this index long enough to be a solution word
+        }
+        std::cout << kernel.first << ": " << (mismatchCount == 0 ? "matches" : "MISMATCHES") << " the plain C++ version";
+        std::cout << (mismatchCount == 0 ? "" : " on " + std::to_string(mismatchCount) + " texts") << std::endl;
+        allMatch = allMatch && mismatchCount == 0;
+    }
+    for(const auto &kernel : maskKernels)
+    {
+        size_t mismatchCount = 0;
+        for(size_t cellCount : textLengths)
+        {
+            for(int trial = 0; trial < 16; trial++)
             {
-                insertResultWord(workingWord); //Add word to solution list
-
-                //NOTE: if needed, these words could instead be moved to another location and restored later
-                (*wordContainer).erase((*wordContainer).begin() + tempIndex); //Remove word from legal words to reduce search time and avoid duplicates;
-            
-                if((*wordContainer).empty()) //If that was the last word in the container, remove it from the map
+                int symbolCount = trial % 2 == 0 ? maxAlphabetSize : 1 + trial; //Sometimes few symbols, so the mask has gaps
+                std::vector<int8_t> cellSymbols(cellCount);
+                for(int8_t &cellSymbol : cellSymbols)
+                {
+                    cellSymbol = generator() % 8 == 0 ? -1 : int8_t(generator() % symbolCount);
+                }
+                if(kernel.second(cellSymbols.data(), cellCount) != symbolMaskScalar(cellSymbols.data(), cellCount))
                 {
-                    alphabeticalWordContainers.erase(startingLetterValue);
-                    return -1; //No need to search for more words since the container for this starting letter is now empty
+                    mismatchCount++;
                 }
             }
+        }
+        std::cout << kernel.first << ": " << (mismatchCount == 0 ? "matches" : "MISMATCHES") << " the plain C++ version";
+        std::cout << (mismatchCount == 0 ? "" : " on " + std::to_string(mismatchCount) + " cell lists") << std::endl;
+        allMatch = allMatch && mismatchCount == 0;
+    }
+    return allMatch;
+}
+
+//Start building a new dictionary, dropping the current one
+void c_boggle::beginLegalWords()
+{
+    buildTrieNodes.assign(1, {-1, -1, 0, false}); //Root node, representing the empty string
+    buildWordLettersSize = 0;
+}
+
+c_boggle::c_symbol_alphabet c_boggle::defaultAlphabet()
+{
+    c_symbol_alphabet letterAlphabet = {};
+    letterAlphabet.symbolCount = 26;
+    for(int letterIndex = 0; letterIndex < 26; letterIndex++)
+    {
+        letterAlphabet.symbolTexts[letterIndex][0] = 'a' + letterIndex;
+    }
+    return letterAlphabet;
+}
 
-            if(checkNextLetter(currentLetterPosition, startingLetterValue, workingWord) == -1){return -1;}
-            else{return 1;} //Break out of function because all paths from this substring have now been checked
+//Find the longest symbol of an alphabet that the text starts with, treating ASCII letters in the text as lowercase
+//Returns: the symbol's code, with its length in symbolLength, or -1 if no symbol matches
+int c_boggle::matchSymbol(const c_symbol_alphabet &symbolAlphabet, const char *text, size_t textLength, size_t &symbolLength)
+{
+    int matchedSymbol = -1;
+    symbolLength = 0;
+    for(int symbolIndex = 0; symbolIndex < (int)symbolAlphabet.symbolCount; symbolIndex++)
+    {
+        const char *symbolText = symbolAlphabet.symbolTexts[symbolIndex];
+        size_t matchLength = 0;
+        while(symbolText[matchLength] != '\0' && matchLength < textLength && (unsigned char)symbolText[matchLength] == std::tolower((unsigned char)text[matchLength]))
+        {
+            matchLength++;
         }
-        else if(comparisonResult > 0) //Substring is alphabetically after the word at current index
+        if(symbolText[matchLength] == '\0' && matchLength > symbolLength)
         {
-            if(currentSearchIndex == lowerIndex){return 1;} //End of upper bounds; no match
-            if (currentSearchIndex == upperIndex - 1) //If we are one index away from the end, we need to just add one to the search index
-            {
-                previousIndex = currentSearchIndex;
-                currentSearchIndex++;
-            }
-            else //Otherwise continue binary search
-            {
-                previousIndex = currentSearchIndex;
-                lowerIndex = currentSearchIndex;
-                currentSearchIndex = currentSearchIndex + (((float)upperIndex - currentSearchIndex) / 2);
-            }
+            matchedSymbol = symbolIndex;
+            symbolLength = matchLength;
         }
-               
-        else if(comparisonResult < 0) //Substring is alphabetically before the word at current index
+    }
+    return matchedSymbol;
+}
+
+//Point the solver at the alphabet of a dictionary, and note which symbols can be recognized from their first byte alone,
+//and whether the alphabet is just the letters from 'a', which the board reading kernels handle
+void c_boggle::useAlphabet(const c_symbol_alphabet *newAlphabet)
+{
+    alphabet = newAlphabet;
+    std::fill(std::begin(symbolsByFirstByte), std::end(symbolsByFirstByte), -1);
+    lettersAreSymbols = true;
+    for(int symbolIndex = 0; symbolIndex < (int)alphabet->symbolCount; symbolIndex++)
+    {
+        const char *symbolText = alphabet->symbolTexts[symbolIndex];
+        lettersAreSymbols = lettersAreSymbols && symbolText[0] == 'a' + symbolIndex && symbolText[1] == '\0';
+        for(unsigned char firstByte : {(unsigned char)symbolText[0], (unsigned char)std::toupper((unsigned char)symbolText[0])})
         {
-            if(currentSearchIndex == upperIndex){return 1;} //End of lower bounds; no match
+            bool singleByteSymbol = (symbolText[1] == '\0' && symbolsByFirstByte[firstByte] == -1);
+            symbolsByFirstByte[firstByte] = singleByteSymbol ? symbolIndex : -2;
+        }
+    }
+}
 
-            if (currentSearchIndex == lowerIndex + 1) //If we are one index away from the lower, we need to just subtract one to the search index
-            {
-                previousIndex = currentSearchIndex;
-                currentSearchIndex--;
-            }
-            else //Otherwise continue binary search
-            {
-                previousIndex = currentSearchIndex;
-                upperIndex = currentSearchIndex;
-                currentSearchIndex -= (((float)currentSearchIndex - lowerIndex) / 2);
-            }
+c_boggle::c_boggle()
+{
+    useAlphabet(&buildAlphabet);
+}
+
+bool c_boggle::set_alphabet(const std::vector<std::string> &symbols)
+{
+    if(symbols.empty() || symbols.size() > maxAlphabetSize)
+    {
+        std::cout << "An alphabet needs between 1 and " << maxAlphabetSize << " symbols!" << std::endl;
+        return false;
+    }
+    c_symbol_alphabet newAlphabet = {};
+    newAlphabet.symbolCount = symbols.size();
+    for(size_t symbolIndex = 0; symbolIndex < symbols.size(); symbolIndex++)
+    {
+        const std::string &symbol = symbols[symbolIndex];
+        if(symbol.empty() || symbol.length() > maxSymbolLength || symbol.find('\0') != std::string::npos
+            || std::find(symbols.begin(), symbols.begin() + symbolIndex, symbol) != symbols.begin() + symbolIndex)
+        {
+            std::cout << "Alphabet symbols must be distinct and 1 to " << maxSymbolLength << " bytes long!" << std::endl;
+            return false;
+        }
+        for(size_t byteIndex = 0; byteIndex < symbol.length(); byteIndex++)
+        {
+            newAlphabet.symbolTexts[symbolIndex][byteIndex] = std::tolower((unsigned char)symbol[byteIndex]);
         }
-        if(previousIndex == currentSearchIndex) {return 1;} //If we have stalled at one index there is no match
     }
-    return 1;
+    buildAlphabet = newAlphabet;
+    if(alphabet == &buildAlphabet) //No dictionary yet, so boards are read with this alphabet too
+    {
+        useAlphabet(&buildAlphabet);
+    }
+    return true;
 }
 
-//Helper function to iterate through each adjacent letter and check if the substring made by adding it to the current
-//working work exists in the dictionary of legal words.
-//Returns: 1 if no problems; -1 if word container for this starting letter was emptied
-int c_boggle::checkNextLetter(int currentLetterPosition, int startingLetterValue, std::string &workingWord)
+//Add one word to the trie being built, so that the solver can check a new symbol against the dictionary by stepping a single
+//node instead of searching a word list. Surrounding whitespace is ignored and uppercase letters are converted to lowercase;
+//the word is split into symbols of the alphabet, and rejected if any part of it isn't a symbol, since it could never be
+//spelled on the board.
+//Returns: false if the word was rejected
+bool c_boggle::addLegalWord(const char *wordLetters, size_t wordLength)
 {
-    int nextLetterPosition; //Position of the possible next letter in the word
+    while(wordLength > 0 && std::isspace((unsigned char)wordLetters[0])) //Trim leading whitespace
+    {
+        wordLetters++;
+        wordLength--;
+    }
+    while(wordLength > 0 && std::isspace((unsigned char)wordLetters[wordLength - 1])) //Trim trailing whitespace, including the \r of Windows line endings
+    {
+        wordLength--;
+    }
+    if(wordLength == 0)
+    {
+        return false;
+    }
+    size_t symbolLength;
+    for(size_t letterIndex = 0; letterIndex < wordLength; letterIndex += symbolLength) //Check the whole word before changing the trie
+    {
+        if(matchSymbol(buildAlphabet, wordLetters + letterIndex, wordLength - letterIndex, symbolLength) == -1)
+        {
+            return false;
+        }
+    }
+    size_t letterCount = 0; //Letters in the word, counting each UTF-8 character once and a "qu" tile as two
+    for(size_t letterIndex = 0; letterIndex < wordLength; letterIndex++)
+    {
+        letterCount += ((unsigned char)wordLetters[letterIndex] & 0xC0) != 0x80;
+    }
+    if(letterCount < 3) //Words shorter than three letters never score, so there is no need to look for them
+    {
+        return true;
+    }
+    if(wordLength > size_t(std::numeric_limits<int32_t>::max()) - buildWordLettersSize) //Word offsets are 32 bits, so the letters of all words together have to fit
+    {
+        return false;
+    }
 
-    //Lambda function perform operations using the current next letter position
-    auto letterCheck = [&] () 
+    int currentNode = 0; //Start every word at the root
+    for(size_t letterIndex = 0; letterIndex < wordLength; letterIndex += symbolLength) //Walk down the trie, adding any nodes that don't exist yet
     {
-        if(!isLetterUsed[nextLetterPosition]) //Make sure the letter hasn't already been used
+        int8_t letter = matchSymbol(buildAlphabet, wordLetters + letterIndex, wordLength - letterIndex, symbolLength);
+        int32_t *childLink = &buildTrieNodes[currentNode].firstChild; //Link to follow or insert at, keeping children sorted by letter
+        while(*childLink != -1 && buildTrieNodes[*childLink].letter < letter)
         {
-            workingWord.push_back(working_board_letters[nextLetterPosition]); //Add the next letter to the working word path
-            isLetterUsed[nextLetterPosition] = true; //Mark the new letter as used in the current path
-            if(searchForSubstring(nextLetterPosition, startingLetterValue, workingWord) == -1)
-            {
-                return -1;
-            }
-            workingWord.pop_back(); //Remove the letter from the working word path to check other paths
-            isLetterUsed[nextLetterPosition] = false; //Unmark this letter as used for the current path
+            childLink = &buildTrieNodes[*childLink].nextSibling;
         }
-        return 1;
-    };
+        if(*childLink == -1 || buildTrieNodes[*childLink].letter != letter)
+        {
+            int32_t newNode = buildTrieNodes.size();
+            int32_t nextSibling = *childLink;
+            *childLink = newNode; //Link the new node in before adding it, since adding it can reallocate the trie
+            buildTrieNodes.push_back({-1, nextSibling, letter, false});
+            currentNode = newNode;
+        }
+        else
+        {
+            currentNode = *childLink;
+        }
+    }
+    if(!buildTrieNodes[currentNode].isWord) //Duplicate words are only added once
+    {
+        buildTrieNodes[currentNode].isWord = true;
+        buildWordLettersSize += wordLength;
+    }
+    return true;
+}
+
+//Work out the offset of each section of a dictionary from the counts in its header; the last entry is the total size
+void c_boggle::getDictionarySections(const c_dictionary_file_header &header, size_t sectionOffsets[5])
+{
+    sectionOffsets[0] = alignDictionarySection(sizeof(c_dictionary_file_header)); //Trie nodes
+    sectionOffsets[1] = alignDictionarySection(sectionOffsets[0] + sizeof(c_trie_node) * (size_t)header.trieNodeCount); //Subtree word counts
+    sectionOffsets[2] = alignDictionarySection(sectionOffsets[1] + sizeof(int32_t) * (size_t)header.trieNodeCount); //Word offsets
+    sectionOffsets[3] = alignDictionarySection(sectionOffsets[2] + sizeof(int32_t) * ((size_t)header.legalWordCount + 1)); //Word letters
+    sectionOffsets[4] = alignDictionarySection(sectionOffsets[3] + header.wordLettersSize); //End of the dictionary
+}
 
-    //Check the 8 letters surrounding the current one; for each possible position, check first if the current letter has a neighbor at said position
-    if(currentLetterPosition >= working_board_width)//Not on top row of board
+//Finish the dictionary once every word has been added: lay the trie out in a single arena with the same layout as a dictionary
+//file, so it takes one allocation, and start using it for solving. Nodes are laid out breadth first, which puts the children
+//of each node next to each other in letter order; words are then numbered alphabetically by walking the trie depth first.
+void c_boggle::finishLegalWords()
+{
+    //Find the breadth first order of the nodes; compactIndexes maps a build node to its position in that order
+    std::vector<int32_t> nodeOrder(1, 0), compactIndexes(buildTrieNodes.size());
+    int legalWords = 0, longestWord = 0;
+    std::vector<int> nodeDepths(buildTrieNodes.size(), 0);
+    for(size_t orderIndex = 0; orderIndex < nodeOrder.size(); orderIndex++)
     {
-        if((currentLetterPosition % working_board_width) != 0) //Not on left side of board
+        int32_t buildNode = nodeOrder[orderIndex];
+        compactIndexes[buildNode] = orderIndex;
+        legalWords += buildTrieNodes[buildNode].isWord;
+        longestWord = std::max(longestWord, nodeDepths[buildNode]);
+        for(int32_t childNode = buildTrieNodes[buildNode].firstChild; childNode != -1; childNode = buildTrieNodes[childNode].nextSibling)
         {
-            nextLetterPosition = currentLetterPosition - working_board_width - 1; //Top left letter
-            if(letterCheck() == -1){return -1;}
+            nodeDepths[childNode] = nodeDepths[buildNode] + 1;
+            nodeOrder.push_back(childNode);
         }
+    }
+    nodeDepths = {};
 
-            nextLetterPosition = currentLetterPosition - working_board_width; //Top middle
-            if(letterCheck() == -1){return -1;}
+    c_dictionary_file_header header = {};
+    std::memcpy(header.magic, "BOGLDICT", sizeof(header.magic));
+    header.formatVersion = 4;
+    header.trieNodeSize = sizeof(c_trie_node);
+    header.trieNodeCount = nodeOrder.size();
+    header.legalWordCount = legalWords;
+    header.maxWordLength = longestWord;
+    header.wordLettersSize = buildWordLettersSize;
+    header.alphabet = buildAlphabet;
+    size_t sectionOffsets[5];
+    getDictionarySections(header, sectionOffsets);
 
-        if(((currentLetterPosition+1) % working_board_width) !=0) //Not on right side of board
+    std::vector<uint64_t> newDictionary(sectionOffsets[4] / sizeof(uint64_t)); //Sections are 8 byte aligned, so the total is too
+    char *newDictionaryBytes = reinterpret_cast<char *>(newDictionary.data());
+    std::memcpy(newDictionaryBytes, &header, sizeof(header));
+    c_trie_node *newTrieNodes = reinterpret_cast<c_trie_node *>(newDictionaryBytes + sectionOffsets[0]);
+    int32_t *newSubtreeWordCounts = reinterpret_cast<int32_t *>(newDictionaryBytes + sectionOffsets[1]);
+    int32_t *newWordOffsets = reinterpret_cast<int32_t *>(newDictionaryBytes + sectionOffsets[2]);
+    char *newWordLetters = newDictionaryBytes + sectionOffsets[3];
+
+    for(size_t orderIndex = 0; orderIndex < nodeOrder.size(); orderIndex++)
+    {
+        const c_build_trie_node &buildNode = buildTrieNodes[nodeOrder[orderIndex]];
+        c_trie_node &newNode = newTrieNodes[orderIndex];
+        newNode.childLetters = 0;
+        newNode.firstChild = (buildNode.firstChild == -1) ? -1 : compactIndexes[buildNode.firstChild];
+        newNode.wordIndex = buildNode.isWord ? 0 : -1; //Placeholder index; replaced by the alphabetical index below
+        newNode.subtreeLetters = 0; //Filled in below, once every node has been placed
+        for(int32_t childNode = buildNode.firstChild; childNode != -1; childNode = buildTrieNodes[childNode].nextSibling)
         {
-            nextLetterPosition = currentLetterPosition - working_board_width + 1; //Top right
-            if(letterCheck() == -1){return -1;}
+            newNode.childLetters |= uint32_t(1) << buildTrieNodes[childNode].letter;
         }
     }
+    buildTrieNodes = {};
+    nodeOrder = {};
+    compactIndexes = {};
 
-    if((currentLetterPosition % working_board_width) != 0) //Not on left side of board
+    //Children always come after their parent in breadth first order, so walking the nodes backwards visits every child before its parent
+    for(int currentNode = header.trieNodeCount - 1; currentNode >= 0; currentNode--)
     {
-        nextLetterPosition = currentLetterPosition - 1; //Middle left
-        if(letterCheck() == -1){return -1;}
+        newSubtreeWordCounts[currentNode] = (newTrieNodes[currentNode].wordIndex != -1);
+        for(int childIndex = 0; childIndex < __builtin_popcount(newTrieNodes[currentNode].childLetters); childIndex++)
+        {
+            newSubtreeWordCounts[currentNode] += newSubtreeWordCounts[newTrieNodes[currentNode].firstChild + childIndex];
+        }
     }
 
-    if(((currentLetterPosition+1) % working_board_width) !=0) //Not on right side of board
+    //Find the letters on the path to every node, parents first, then walk backwards to find the letters every word at or below
+    //each node has in common; a word node's own letters are the most any of its subtree can have in common
+    std::vector<uint32_t> pathLetters(header.trieNodeCount, 0);
+    for(int currentNode = 0; currentNode < (int)header.trieNodeCount; currentNode++)
+    {
+        for(uint32_t remainingLetters = newTrieNodes[currentNode].childLetters; remainingLetters != 0; remainingLetters &= remainingLetters - 1)
+        {
+            int letterIndex = __builtin_ctz(remainingLetters);
+            pathLetters[trieChild(newTrieNodes, currentNode, letterIndex)] = pathLetters[currentNode] | (uint32_t(1) << letterIndex);
+        }
+    }
+    for(int currentNode = header.trieNodeCount - 1; currentNode >= 0; currentNode--)
     {
-        nextLetterPosition = currentLetterPosition + 1; //Middle right
-        if(letterCheck() == -1){return -1;}
+        uint32_t commonLetters = (newTrieNodes[currentNode].wordIndex != -1) ? pathLetters[currentNode] : ~uint32_t(0);
+        for(int childIndex = 0; childIndex < __builtin_popcount(newTrieNodes[currentNode].childLetters); childIndex++)
+        {
+            commonLetters &= newTrieNodes[newTrieNodes[currentNode].firstChild + childIndex].subtreeLetters;
+        }
+        newTrieNodes[currentNode].subtreeLetters = commonLetters;
     }
+    pathLetters = {};
 
-    if(currentLetterPosition < (board_size - working_board_width)) //Not on bottom of board
+    //Number the words alphabetically, so that sorting found word indexes sorts the words themselves; visiting a node before
+    //its children, and children in letter order, means a word comes before any longer word that starts with it
+    std::vector<std::pair<int, int>> nodeStack(1, {0, -1}); //Trie node and the last of its children visited so far
+    std::string currentWord; //Letters of the path to the node on top of the stack
+    int nextWordIndex = 0;
+    newWordOffsets[0] = 0;
+    while(!nodeStack.empty())
     {
-        if((currentLetterPosition % working_board_width) != 0) //Not on left side of board
+        int currentNode = nodeStack.back().first;
+        int &lastChildIndex = nodeStack.back().second;
+        if(lastChildIndex == -1 && newTrieNodes[currentNode].wordIndex != -1) //First visit to a word node
         {
-            nextLetterPosition = currentLetterPosition + working_board_width - 1; //Bottom left
-            if(letterCheck() == -1){return -1;}
+            newTrieNodes[currentNode].wordIndex = nextWordIndex;
+            std::memcpy(newWordLetters + newWordOffsets[nextWordIndex], currentWord.data(), currentWord.length());
+            newWordOffsets[nextWordIndex + 1] = newWordOffsets[nextWordIndex] + currentWord.length();
+            nextWordIndex++;
         }
+        uint32_t remainingLetters = (lastChildIndex == 31) ? 0 : newTrieNodes[currentNode].childLetters >> (lastChildIndex + 1) << (lastChildIndex + 1);
+        if(remainingLetters == 0) //Every child has been visited
+        {
+            nodeStack.pop_back();
+            if(!nodeStack.empty()) //Take the symbol leading to this node off the end of the word
+            {
+                currentWord.resize(currentWord.length() - std::strlen(buildAlphabet.symbolTexts[nodeStack.back().second]));
+            }
+            continue;
+        }
+        lastChildIndex = __builtin_ctz(remainingLetters);
+        currentWord += buildAlphabet.symbolTexts[lastChildIndex];
+        nodeStack.push_back({trieChild(newTrieNodes, currentNode, lastChildIndex), -1});
+    }
+
+    unmapDictionary();
+    builtDictionary.swap(newDictionary);
+    useDictionary(reinterpret_cast<const char *>(builtDictionary.data()), builtDictionary.size() * sizeof(uint64_t));
+}
 
-            nextLetterPosition = currentLetterPosition + working_board_width; //Bottom middle
-            if(letterCheck() == -1){return -1;}
+void c_boggle::set_legal_words(const std::vector<std::string> &all_words)
+{
+    beginLegalWords();
+    for(const std::string &word : all_words)
+    {
+        addLegalWord(word.data(), word.length());
+    }
+    finishLegalWords();
+}
 
-        if(((currentLetterPosition+1) % working_board_width) !=0) //Not on right side of board
+//Read words one line at a time straight into the trie, so the whole list never has to be held in memory
+int c_boggle::load_legal_words(std::istream &word_stream)
+{
+    int rejectedWordCount = 0;
+    std::string line; //Reused for every line, so the only extra memory is the longest line
+    beginLegalWords();
+    while(std::getline(word_stream, line))
+    {
+        if(!addLegalWord(line.data(), line.length()) && !line.empty())
         {
-            nextLetterPosition = currentLetterPosition + working_board_width + 1; //Bottom right
-            if(letterCheck() == -1){return -1;}
+            rejectedWordCount++;
         }
     }
+    if(word_stream.bad()) //getline stops on a read error just as it does at the end of the stream
+    {
+        std::cout << "Could not read legal words!" << std::endl;
+        buildTrieNodes = {}; //Keep the legal words from before
+        return -1;
+    }
+    finishLegalWords();
+    return rejectedWordCount;
+}
+
+//Same as above, reading the file descriptor in fixed size blocks; a line split across two blocks is carried over to the next
+int c_boggle::load_legal_words(int file_descriptor)
+{
+    int rejectedWordCount = 0;
+    char readBuffer[65536];
+    std::string partialLine; //Start of a line that ran off the end of the previous block
+    ssize_t bytesRead;
+    beginLegalWords();
+
+    auto addLine = [&] (const char *lineLetters, size_t lineLength)
+    {
+        if(!addLegalWord(lineLetters, lineLength) && lineLength > 0)
+        {
+            rejectedWordCount++;
+        }
+    };
 
-    return 1;
+    while((bytesRead = read(file_descriptor, readBuffer, sizeof(readBuffer))) != 0)
+    {
+        if(bytesRead < 0)
+        {
+            if(errno == EINTR) //Interrupted by a signal before anything was read
+            {
+                continue;
+            }
+            std::cout << "Could not read legal words: " << std::strerror(errno) << "!" << std::endl;
+            buildTrieNodes = {}; //Keep the legal words from before
+            return -1;
+        }
+        const char *lineStart = readBuffer, *blockEnd = readBuffer + bytesRead;
+        const char *lineEnd;
+        while((lineEnd = static_cast<const char *>(std::memchr(lineStart, '\n', blockEnd - lineStart))) != nullptr)
+        {
+            if(partialLine.empty())
+            {
+                addLine(lineStart, lineEnd - lineStart);
+            }
+            else
+            {
+                partialLine.append(lineStart, lineEnd);
+                addLine(partialLine.data(), partialLine.length());
+                partialLine.clear();
+            }
+            lineStart = lineEnd + 1;
+        }
+        partialLine.append(lineStart, blockEnd);
+    }
+    addLine(partialLine.data(), partialLine.length()); //Last line, if the input doesn't end with a newline
+    finishLegalWords();
+    return rejectedWordCount;
 }
 
-std::vector<std::string> c_boggle::solve_board(int board_width, int board_height, const char *board_letters)
+c_boggle::~c_boggle()
 {
-    std::string currentWorkingWord = ""; //String that will be built as we go through letter paths
-    int startingLetterValue = -117; //ASCII value of the letter at the front of the working word
-    int currentLetterPosition = -117; //Position of starting letter on the board
-    working_board_letters = board_letters;
-    working_board_height = board_height;
-    working_board_width = board_width;
-    board_size = board_width * board_height;
+    unmapDictionary();
+}
 
-    if(std::strlen(board_letters) != board_size)
+void c_boggle::unmapDictionary()
+{
+    if(mappedDictionary != nullptr)
     {
-        std::cout << "Number of letters does not match board size!" << std::endl;
-        return resultWordsList;
+        munmap(mappedDictionary, mappedDictionarySize);
+        mappedDictionary = nullptr;
+        mappedDictionarySize = 0;
     }
+}
 
-    //Iterate over ever letter on the board as a starting letter
-    for(int currentRow = 0; currentRow < board_height; currentRow++){
-        for(int currentColumn = 0; currentColumn < board_width; currentColumn++)
+//Check that a block of memory holds a dictionary in the layout described by c_dictionary_file_header, and if so point the
+//solver at its sections; nothing is copied, whether the dictionary was built from a word list or mapped from a file
+bool c_boggle::useDictionary(const char *newDictionaryBytes, size_t newDictionarySize)
+{
+    if(newDictionarySize < sizeof(c_dictionary_file_header))
+    {
+        return false;
+    }
+    const c_dictionary_file_header &header = *reinterpret_cast<const c_dictionary_file_header *>(newDictionaryBytes);
+    const uint32_t maxCount = std::numeric_limits<int32_t>::max(); //Counts, indexes and offsets are read as 32-bit ints
+    if(std::memcmp(header.magic, "BOGLDICT", sizeof(header.magic)) != 0 || header.formatVersion != 4 || header.trieNodeSize != sizeof(c_trie_node)
+        || header.trieNodeCount == 0 || header.trieNodeCount > maxCount || header.legalWordCount >= maxCount || header.maxWordLength >= maxCount
+        || header.wordLettersSize > maxCount || header.alphabet.symbolCount == 0 || header.alphabet.symbolCount > maxAlphabetSize)
+    {
+        return false;
+    }
+    size_t sectionOffsets[5];
+    getDictionarySections(header, sectionOffsets); //Can't overflow once the counts are known to fit in 31 bits
+    if(sectionOffsets[4] > newDictionarySize)
+    {
+        return false;
+    }
+    for(int symbolIndex = 0; symbolIndex < (int)header.alphabet.symbolCount; symbolIndex++)
+    {
+        if(header.alphabet.symbolTexts[symbolIndex][0] == '\0' || header.alphabet.symbolTexts[symbolIndex][maxSymbolLength] != '\0')
+        {
+            return false;
+        }
+    }
+
+    //The searches follow child indexes, word indexes and word offsets without checking them, so check every one once here, since a
+    //file could have any values in them. Children have to come after their parent, as they do in breadth first order, so the trie
+    //can't loop, and the longest word, which the search stacks are sized by, has to be the depth of the deepest node
+    const c_trie_node *newTrieNodes = reinterpret_cast<const c_trie_node *>(newDictionaryBytes + sectionOffsets[0]);
+    const int32_t *newSubtreeWordCounts = reinterpret_cast<const int32_t *>(newDictionaryBytes + sectionOffsets[1]);
+    const int32_t *newWordOffsets = reinterpret_cast<const int32_t *>(newDictionaryBytes + sectionOffsets[2]);
+    uint32_t symbolLetters = header.alphabet.symbolCount == 32 ? ~uint32_t(0) : (uint32_t(1) << header.alphabet.symbolCount) - 1;
+    std::vector<uint32_t> nodeDepths(header.trieNodeCount, 0);
+    uint32_t trieDepth = 0;
+    for(uint32_t currentNode = 0; currentNode < header.trieNodeCount; currentNode++)
+    {
+        const c_trie_node &node = newTrieNodes[currentNode];
+        if((node.childLetters & ~symbolLetters) != 0 || node.wordIndex < -1 || node.wordIndex >= (int64_t)header.legalWordCount
+            || newSubtreeWordCounts[currentNode] < 0 || (uint32_t)newSubtreeWordCounts[currentNode] > header.legalWordCount)
         {
-            isLetterUsed.assign(board_width*board_height, false); //Reset the used letter list
-            currentLetterPosition = currentRow * board_height + currentColumn;
-            isLetterUsed[currentLetterPosition] = true; //Mark this letter as used to prevent reuse in current path
-            currentWorkingWord = board_letters[currentLetterPosition]; //Start the current working word with the letter at this board position
-            startingLetterValue = int(board_letters[currentRow * board_height + currentColumn]); //Get ASCII value of current starting letter
-            if(alphabeticalWordContainers.find(startingLetterValue) == alphabeticalWordContainers.end()) //If there is no container of words that start with this letter, move on to the next letter
+            return false;
+        }
+        trieDepth = std::max(trieDepth, nodeDepths[currentNode]);
+        if(node.childLetters != 0)
+        {
+            uint32_t childCount = __builtin_popcount(node.childLetters);
+            if(node.firstChild <= (int64_t)currentNode || (uint64_t)node.firstChild + childCount > header.trieNodeCount)
             {
-                continue;
+                return false;
+            }
+            for(uint32_t childNode = node.firstChild; childNode < node.firstChild + childCount; childNode++)
+            {
+                nodeDepths[childNode] = std::max(nodeDepths[childNode], nodeDepths[currentNode] + 1);
             }
-            checkNextLetter(currentLetterPosition, startingLetterValue, currentWorkingWord);
-            isLetterUsed[currentLetterPosition] = false; //Unmark this letter as in use
         }
     }
-    return resultWordsList;
+    if(trieDepth != header.maxWordLength || newWordOffsets[0] != 0)
+    {
+        return false;
+    }
+    for(uint32_t wordIndex = 0; wordIndex < header.legalWordCount; wordIndex++)
+    {
+        if(newWordOffsets[wordIndex + 1] < newWordOffsets[wordIndex] || (uint64_t)newWordOffsets[wordIndex + 1] > header.wordLettersSize)
+        {
+            return false;
+        }
+    }
+
+    dictionaryBytes = newDictionaryBytes;
+    dictionarySize = sectionOffsets[4];
+    trieNodes = reinterpret_cast<const c_trie_node *>(newDictionaryBytes + sectionOffsets[0]);
+    trieNodeCount = header.trieNodeCount;
+    trieSubtreeWordCounts = reinterpret_cast<const int32_t *>(newDictionaryBytes + sectionOffsets[1]);
+    legalWordCount = header.legalWordCount;
+    legalWordOffsets = reinterpret_cast<const int32_t *>(newDictionaryBytes + sectionOffsets[2]);
+    legalWordLetters = newDictionaryBytes + sectionOffsets[3];
+    maxWordLength = header.maxWordLength;
+    useAlphabet(&header.alphabet);
+    solveState = c_solve_state(); //Found word stamps are sized for the old dictionary, so start over
+    editableBoard = c_editable_board(); //Path counts are for the old dictionary's words, so the board has to be set again
+    return true;
+}
+
+//The dictionary is already laid out as a dictionary file, so saving it is a single write
+bool c_boggle::save_dictionary(const char *file_path) const
+{
+    if(trieNodeCount == 0)
+    {
+        std::cout << "No legal words to save!" << std::endl;
+        return false;
+    }
+
+    std::ofstream dictionaryFile(file_path, std::ios::binary | std::ios::trunc);
+    dictionaryFile.write(dictionaryBytes, dictionarySize);
+    if(!dictionaryFile.good())
+    {
+        std::cout << "Could not write dictionary file " << file_path << std::endl;
+        return false;
+    }
+    return true;
 }
 
+//Map a compiled dictionary file read-only and solve against it in place. Loading reads the trie and word offsets once to check
+//them, a few milliseconds for a large dictionary; the word letters are only read in from disk (or shared from another process)
+//as they are used
+bool c_boggle::load_dictionary(const char *file_path)
+{
+    int fileDescriptor = open(file_path, O_RDONLY);
+    if(fileDescriptor == -1)
+    {
+        std::cout << "Could not open dictionary file " << file_path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat fileStatus;
+    if(fstat(fileDescriptor, &fileStatus) != 0)
+    {
+        std::cout << "Could not read the size of dictionary file " << file_path << ": " << std::strerror(errno) << std::endl;
+        close(fileDescriptor);
+        return false;
+    }
+    if(fileStatus.st_size == 0)
+    {
+        std::cout << "Dictionary file " << file_path << " is empty" << std::endl;
+        close(fileDescriptor);
+        return false;
+    }
+    void *fileMapping = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    int mapError = errno; //close could overwrite it
+    close(fileDescriptor); //The mapping stays valid after the file is closed
+    if(fileMapping == MAP_FAILED)
+    {
+        std::cout << "Could not map dictionary file " << file_path << ": " << std::strerror(mapError) << std::endl;
+        return false;
+    }
+
+    //Keep the current dictionary alive until the new one has been checked, so a bad file leaves the solver unchanged
+    void *previousMapping = mappedDictionary;
+    size_t previousMappingSize = mappedDictionarySize;
+    if(!useDictionary(static_cast<const char *>(fileMapping), fileStatus.st_size))
+    {
+        std::cout << "File " << file_path << " is not a compatible dictionary" << std::endl;
+        munmap(fileMapping, fileStatus.st_size);
+        return false;
+    }
+    if(previousMapping != nullptr)
+    {
+        munmap(previousMapping, previousMappingSize);
+    }
+    mappedDictionary = fileMapping;
+    mappedDictionarySize = fileStatus.st_size;
+    builtDictionary = {};
+    return true;
+}
 
-void example_driver()
+std::string_view c_boggle::legal_word(int word_index) const
 {
-	c_boggle my_boggle;
-	std::vector<std::string> my_results;
+    return std::string_view(legalWordLetters + legalWordOffsets[word_index], legalWordOffsets[word_index + 1] - legalWordOffsets[word_index]);
+}
 
-	my_boggle.set_legal_words({"abed","abo","aby","aero","aery","bad","bade","be","bead","bed","boa","board","bore","bored","box","boy","bread","bred","bro","broad","byre","byroad","dab","deb","derby","dev","dove","oba","obe","orb","orbed","orby","ore","oread","read","reb","red","rev","road","rob","robe","robed","robbed","robber","robed","verb","very","yob","yore"});
-	my_results= my_boggle.solve_board(3, 3, "yoxrbaved");
-    for (std::string word : my_results)
+std::vector<std::string> c_boggle::wordsFromIndexes(const std::vector<int> &wordIndexes) const
+{
+    std::vector<std::string> words;
+    words.reserve(wordIndexes.size());
+    for(int wordIndex : wordIndexes)
     {
-        std::cout << word << std::endl;
+        words.emplace_back(legal_word(wordIndex));
     }
+    return words;
 }
 
-int main()
+//Build the neighbour table for a board shape, or return the one built by an earlier solve; the table is the only place that
+//knows how cells connect, so other board topologies (wrapping edges, 4-connected or hex grids) only need a different table here
+std::shared_ptr<const c_boggle::c_board_adjacency> c_boggle::getAdjacency(int board_width, int board_height) const
 {
-    example_driver();
+    std::lock_guard<std::mutex> cacheLock(adjacencyCacheMutex);
+    std::shared_ptr<const c_board_adjacency> &cachedAdjacency = adjacencyCache[{board_width, board_height}];
+    if(cachedAdjacency)
+    {
+        return cachedAdjacency;
+    }
+    adjacencyCacheOrder.push_back({board_width, board_height});
+    if(adjacencyCacheOrder.size() > maxCachedAdjacencies) //Forget the oldest shape; states still solving a board of that shape keep their own reference to its table
+    {
+        adjacencyCache.erase(adjacencyCacheOrder.front());
+        adjacencyCacheOrder.pop_front();
+    }
+
+    std::shared_ptr<c_board_adjacency> adjacency = std::make_shared<c_board_adjacency>();
+    adjacency->board_width = board_width;
+    adjacency->board_height = board_height;
+    size_t cellCount = size_t(board_width) * size_t(board_height);
+    adjacency->neighbourStarts.reserve(cellCount + 1);
+    adjacency->neighbourPositions.reserve(cellCount * 8);
+    for(int currentRow = 0; currentRow < board_height; currentRow++)
+    {
+        for(int currentColumn = 0; currentColumn < board_width; currentColumn++)
+        {
+            adjacency->neighbourStarts.push_back(adjacency->neighbourPositions.size());
+            //Add the 8 letters surrounding this one, skipping positions that fall off the edge of the board
+            for(int rowOffset = -1; rowOffset <= 1; rowOffset++)
+            {
+                for(int columnOffset = -1; columnOffset <= 1; columnOffset++)
+                {
+                    int neighbourRow = currentRow + rowOffset, neighbourColumn = currentColumn + columnOffset;
+                    if((rowOffset == 0 && columnOffset == 0) || neighbourRow < 0 || neighbourRow >= board_height
+                        || neighbourColumn < 0 || neighbourColumn >= board_width)
+                    {
+                        continue;
+                    }
+                    adjacency->neighbourPositions.push_back(neighbourRow * board_width + neighbourColumn);
+                }
+            }
+        }
+    }
+    adjacency->neighbourStarts.push_back(adjacency->neighbourPositions.size());
+
+    cachedAdjacency = adjacency;
+    return cachedAdjacency;
 }
 
+//Main search loop: starting from the path given by firstPosition and secondPosition (which can be -1), repeatedly take the
+//next unchecked neighbour of the last letter on the path and step the trie with it; if the trie has a node for the new
+//substring, check if it is a full word from the dictionary and add it to the solution list, then push it and keep building
+//the path. A letter is popped once all of its neighbours have been checked. Uses a visited set and stack supplied by the
+//caller, so the loop itself never allocates.
+template <class t_visited_set>
+void c_boggle::searchPaths(c_solve_state &state, t_visited_set &visitedCells, c_search_frame *pathStack, int firstPosition, int secondPosition) const
+{
+    const int *neighbourStarts = state.adjacency->neighbourStarts.data();
+    const int *neighbourPositions = state.adjacency->neighbourPositions.data();
+    const int8_t *boardSymbols = state.boardSymbols.data();
+    int pathLength = 0; //Number of letters on the stack
+    c_search_counters counters;
+
+    //Push the starting letters of the path
+    for(int pathPosition : {firstPosition, secondPosition})
+    {
+        if(pathPosition == -1)
+        {
+            break;
+        }
+        int pathSymbol = boardSymbols[pathPosition];
+        int parentNode = (pathLength == 0) ? 0 : pathStack[pathLength - 1].node;
+        int pathNode = (pathSymbol < 0) ? -1 : trieChild(trieNodes, parentNode, pathSymbol);
+        if(pathNode == -1 || (state.filterSubtrees && !subtreeIsPossible(state, pathNode))) //If no legal word on this board starts with these letters, there is nothing to search
+        {
+            for(int stackIndex = 0; stackIndex < pathLength; stackIndex++)
+            {
+                visitedCells.clear(pathStack[stackIndex].position);
+            }
+            return;
+        }
+        visitedCells.set(pathPosition); //Mark this letter as used to prevent reuse in current path
+        pathStack[pathLength++] = {pathPosition, pathNode, neighbourStarts[pathPosition], neighbourStarts[pathPosition + 1]};
+        counters.countNode(pathLength);
+        int wordIndex = trieNodes[pathNode].wordIndex;
+        if(wordIndex != -1 && state.wordFoundGeneration[wordIndex] != state.solveGeneration) //A symbol of three or more letters can be a word on its own
+        {
+            counters.countWordCheck();
+            addFoundWord(state, wordIndex, pathStack, pathLength);
+        }
+    }
+    int startingPathLength = pathLength; //The search is done once the last starting letter runs out of neighbours
+
+    while(pathLength >= startingPathLength)
+    {
+        c_search_frame &currentFrame = pathStack[pathLength - 1];
+        if(currentFrame.neighbourIndex == currentFrame.neighbourEnd) //Every path through this letter has been checked
+        {
+            visitedCells.clear(currentFrame.position); //Unmark this letter as used for the current path
+            pathLength--;
+            continue;
+        }
+
+        int nextLetterPosition = neighbourPositions[currentFrame.neighbourIndex++]; //Position of the possible next letter in the word
+        int nextSymbol = boardSymbols[nextLetterPosition];
+        if(visitedCells.test(nextLetterPosition) || nextSymbol < 0) //Make sure the letter hasn't already been used
+        {
+            continue;
+        }
+        int nextNode = trieChild(trieNodes, currentFrame.node, nextSymbol);
+        if(nextNode != -1 && state.filterSubtrees && !subtreeIsPossible(state, nextNode)) //Every word starting with this substring needs a letter the board doesn't have
+        {
+            nextNode = -1;
+        }
+        counters.countProbe(nextNode);
+        if(nextNode == -1) //No legal word starts with this substring, so there is no need to follow this path
+        {
+            continue;
+        }
+
+        visitedCells.set(nextLetterPosition); //Mark the new letter as used in the current path
+        pathStack[pathLength++] = {nextLetterPosition, nextNode, neighbourStarts[nextLetterPosition], neighbourStarts[nextLetterPosition + 1]};
+        counters.countNode(pathLength);
+        int wordIndex = trieNodes[nextNode].wordIndex;
+        if(wordIndex != -1)
+        {
+            counters.countWordCheck();
+            if(state.wordFoundGeneration[wordIndex] != state.solveGeneration) //Substring is a legal word long enough to be a solution word, and hasn't been found on this board yet
+            {
+                addFoundWord(state, wordIndex, pathStack, pathLength); //Add word to solution list
+            }
+        }
+    }
+    counters.addTo(state.stats);
+
+    for(int stackIndex = 0; stackIndex < pathLength; stackIndex++) //Unmark the starting letters that are still on the stack
+    {
+        visitedCells.clear(pathStack[stackIndex].position);
+    }
+}
+
+//Set up the state to solve a new board, clearing any results from the previous board
+//Returns: board_valid, or why the board can't be solved; nothing is printed, since a parallel solve checks the same board once per thread
+c_boggle::c_board_status c_boggle::beginSolve(c_solve_state &state, int board_width, int board_height, const char *board_letters) const
+{
+    state.resultWordIndexes.clear();
+    state.scoreWords = false; //Set again by solveWithState if asked for
+    state.recordPaths = false;
+    state.totalScore = 0;
+    state.foundWords.clear();
+    state.foundPathPositions.clear();
+    state.boardValid = false;
+
+    //Every cell takes at least one byte of text, so check the shape against the text before sizing anything by it; otherwise
+    //a bad shape could make the solver build, and cache, tables for a board far larger than the text
+    size_t boardTextLength = std::strlen(board_letters);
+    size_t boardCellCount = size_t(std::max(board_width, 0)) * size_t(std::max(board_height, 0));
+    if(boardCellCount == 0 || boardCellCount > boardTextLength || boardCellCount > size_t(std::numeric_limits<int>::max()))
+    {
+        state.working_board_width = state.working_board_height = state.board_size = 0;
+        state.boardSymbols.clear();
+        return (boardCellCount == 0 || boardCellCount > size_t(std::numeric_limits<int>::max())) ? board_size_invalid : board_letters_mismatch;
+    }
+    state.working_board_height = board_height;
+    state.working_board_width = board_width;
+    state.board_size = int(boardCellCount);
+#if BOGGLE_SOLVER_STATS
+    std::vector<uint64_t> startCellNanoseconds = std::move(state.stats.start_cell_nanoseconds); //Keep the storage so solving doesn't allocate
+    startCellNanoseconds.assign(state.board_size, 0);
+    state.stats = c_boggle_solve_stats();
+    state.stats.boards_solved = 1;
+    state.stats.start_cell_nanoseconds = std::move(startCellNanoseconds);
+#endif
+    if(state.wordFoundGeneration.size() != (size_t)legalWordCount) //First solve with this state
+    {
+        state.wordFoundGeneration.assign(legalWordCount, 0);
+    }
+    if(++state.solveGeneration == 0) //Generation counter wrapped around, so old stamps could look current; clear them and start over
+    {
+        std::fill(state.wordFoundGeneration.begin(), state.wordFoundGeneration.end(), 0);
+        state.solveGeneration = 1;
+    }
+
+    //Split the board into cells, one symbol each; a character that isn't part of any symbol makes a cell that can't be used in a word.
+    //Most legal words need a symbol that a small board doesn't have, so also note which symbols the board has; subtrees needing
+    //any other symbol are skipped by the search without following them any further
+    state.boardSymbols.resize(boardTextLength); //Every cell takes at least one byte
+    int8_t *cellSymbols = state.boardSymbols.data();
+    size_t letterIndex = 0, cellCount = 0;
+    if(lettersAreSymbols) //Convert as much of the board as possible a block of bytes at a time
+    {
+        letterIndex = cellCount = boardKernels().convertLetterCells(board_letters, cellSymbols, boardTextLength, alphabet->symbolCount);
+    }
+    for(size_t cellLength; letterIndex < boardTextLength; letterIndex += cellLength)
+    {
+        int cellSymbol = symbolsByFirstByte[(unsigned char)board_letters[letterIndex]];
+        cellLength = 1;
+        if(cellSymbol == -2) //Several symbols start with this byte, so find the longest one that matches
+        {
+            cellSymbol = matchSymbol(*alphabet, board_letters + letterIndex, boardTextLength - letterIndex, cellLength);
+        }
+        if(cellSymbol == -1) //Skip the rest of a UTF-8 character that isn't in the alphabet
+        {
+            cellLength = 1;
+            while(letterIndex + cellLength < boardTextLength && ((unsigned char)board_letters[letterIndex + cellLength] & 0xC0) == 0x80)
+            {
+                cellLength++;
+            }
+        }
+        cellSymbols[cellCount++] = cellSymbol;
+    }
+    state.boardSymbols.resize(cellCount);
+    if(cellCount != (size_t)state.board_size)
+    {
+        return board_letters_mismatch;
+    }
+
+    //Only a board that matches its text gets a neighbour table and search storage
+    if(!state.adjacency || state.adjacency->board_width != board_width || state.adjacency->board_height != board_height) //Only look up the cache when the shape changes
+    {
+        state.adjacency = getAdjacency(board_width, board_height);
+    }
+    if(state.board_size > 64) //Large boards keep their visited set and search stack in the state; these only reallocate when they need to grow
+    {
+        state.visitedCellWords.assign((state.board_size + 63) / 64, 0);
+        state.pathStack.resize(std::min(state.board_size, maxWordLength) + 1);
+    }
+    state.boardValid = true;
+    state.boardLetterMask = boardKernels().symbolMask(cellSymbols, cellCount);
+    state.filterSubtrees = state.boardLetterMask != uint32_t((uint64_t(1) << alphabet->symbolCount) - 1); //A board with every symbol can't rule anything out
+    return board_valid;
+}
+
+void c_boggle::reportBoardStatus(c_board_status board_status)
+{
+    if(board_status == board_size_invalid)
+    {
+        std::cout << "Board size is invalid!" << std::endl;
+    }
+    else if(board_status == board_letters_mismatch)
+    {
+        std::cout << "Number of letters does not match board size!" << std::endl;
+    }
+}
+
+//Search every word path that starts at firstPosition, or that starts at firstPosition and then moves to secondPosition
+//if it isn't -1; splitting a start cell by its second cell lets a parallel solve break up start letters with many words.
+//Boards of up to 64 cells keep the visited set in one 64-bit mask and the search stack in a fixed-size local array,
+//since a path can't be longer than the board; larger boards use storage in the state that was sized by beginSolve.
+void c_boggle::searchFromPath(c_solve_state &state, int firstPosition, int secondPosition) const
+{
+    if(trieNodeCount == 0) //No legal words have been set
+    {
+        return;
+    }
+    c_start_cell_timer cellTimer(state.stats, firstPosition);
+    if(state.board_size <= 64)
+    {
+        c_visited_mask visitedCells;
+        c_search_frame pathStack[64];
+        searchPaths(state, visitedCells, pathStack, firstPosition, secondPosition);
+    }
+    else
+    {
+        c_visited_bitset visitedCells = {state.visitedCellWords.data()};
+        searchPaths(state, visitedCells, state.pathStack.data(), firstPosition, secondPosition);
+    }
+}
+
+
+const std::vector<int> &c_boggle::solveWithState(c_solve_state &state, int board_width, int board_height, const char *board_letters, bool scoreWords, bool recordPaths) const
+{
+    c_board_status boardStatus = beginSolve(state, board_width, board_height, board_letters);
+    if(boardStatus == board_valid)
+    {
+        state.scoreWords = scoreWords;
+        state.recordPaths = recordPaths;
+        searchBoard(state);
+    }
+    reportBoardStatus(boardStatus);
+    return state.resultWordIndexes;
+}
+
+void c_boggle::set_fixed_size_search(bool use_fixed_size_search)
+{
+    fixedSizeSearch = use_fixed_size_search;
+}
+
+void c_boggle::searchBoard(c_solve_state &state) const
+{
+    //Use a specialized solver for the board sizes that make up most games
+    if(fixedSizeSearch && state.working_board_width == 4 && state.working_board_height == 4)
+    {
+        searchFixedBoard<4, 4>(state);
+    }
+    else if(fixedSizeSearch && state.working_board_width == 5 && state.working_board_height == 5)
+    {
+        searchFixedBoard<5, 5>(state);
+    }
+    else if(fixedSizeSearch && state.working_board_width == 6 && state.working_board_height == 6)
+    {
+        searchFixedBoard<6, 6>(state);
+    }
+    else
+    {
+        //Iterate over ever letter on the board as a starting letter
+        for(int currentLetterPosition = 0; currentLetterPosition < state.board_size; currentLetterPosition++)
+        {
+            searchFromPath(state, currentLetterPosition, -1);
+        }
+    }
+
+    //Words are collected in the order they are found; since indexes are alphabetical, one sort at the end puts them in order
+    std::sort(state.resultWordIndexes.begin(), state.resultWordIndexes.end());
+}
+
+std::vector<std::string> c_boggle::solve_board(int board_width, int board_height, const char *board_letters, c_boggle_solve_stats *solve_stats)
+{
+    const std::vector<int> &wordIndexes = solveWithState(solveState, board_width, board_height, board_letters);
+    if(solve_stats)
+    {
+        *solve_stats = solveState.stats;
+    }
+    return wordsFromIndexes(wordIndexes);
+}
+
+std::vector<int> c_boggle::solve_board_word_indexes(int board_width, int board_height, const char *board_letters, c_boggle_solve_stats *solve_stats)
+{
+    const std::vector<int> &wordIndexes = solveWithState(solveState, board_width, board_height, board_letters);
+    if(solve_stats)
+    {
+        *solve_stats = solveState.stats;
+    }
+    return wordIndexes;
+}
+
+std::vector<std::string_view> c_boggle::solve_board_word_views(int board_width, int board_height, const char *board_letters, c_boggle_solve_stats *solve_stats)
+{
+    const std::vector<int> &wordIndexes = solveWithState(solveState, board_width, board_height, board_letters);
+    if(solve_stats)
+    {
+        *solve_stats = solveState.stats;
+    }
+    std::vector<std::string_view> wordViews;
+    wordViews.reserve(wordIndexes.size());
+    for(int wordIndex : wordIndexes)
+    {
+        wordViews.push_back(legal_word(wordIndex));
+    }
+    return wordViews;
+}
+
+//Words are scored and their paths copied off the search stack as they are found, so nothing has to search the board again
+//to find a word's path afterwards; sorting the found words by index puts them and their paths in alphabetical order
+bool c_boggle::solve_board_scored(int board_width, int board_height, const char *board_letters, c_boggle_scored_board &scored_board, c_boggle_solve_stats *solve_stats)
+{
+    scored_board.words.clear();
+    scored_board.path_positions.clear();
+    scored_board.total_score = 0;
+    if((long long)board_width * board_height > 256)
+    {
+        std::cout << "Boards solved with paths can have at most 256 cells!" << std::endl;
+        return false;
+    }
+    solveWithState(solveState, board_width, board_height, board_letters, true, true);
+    if(solve_stats)
+    {
+        *solve_stats = solveState.stats;
+    }
+    if(!solveState.boardValid) //Board letters didn't match the board size
+    {
+        return false;
+    }
+
+    std::sort(solveState.foundWords.begin(), solveState.foundWords.end(), [] (const c_boggle_found_word &firstWord, const c_boggle_found_word &secondWord)
+    {
+        return firstWord.word_index < secondWord.word_index;
+    });
+    scored_board.words.assign(solveState.foundWords.begin(), solveState.foundWords.end());
+    scored_board.path_positions.assign(solveState.foundPathPositions.begin(), solveState.foundPathPositions.end());
+    scored_board.total_score = solveState.totalScore;
+    return true;
+}
+
+int c_boggle::solve_board_score(int board_width, int board_height, const char *board_letters, c_boggle_solve_stats *solve_stats)
+{
+    solveWithState(solveState, board_width, board_height, board_letters, true, false);
+    if(solve_stats)
+    {
+        *solve_stats = solveState.stats;
+    }
+    return solveState.totalScore;
+}
+
+bool c_boggle::solve_board_word_indexes(c_solve_workspace &workspace, int board_width, int board_height, const char *board_letters, std::vector<int> &word_indexes, int *board_score) const
+{
+    c_solve_state &state = workspace.state;
+    if(beginSolve(state, board_width, board_height, board_letters) != board_valid)
+    {
+        word_indexes.clear();
+        if(board_score)
+        {
+            *board_score = 0;
+        }
+        return false;
+    }
+    state.scoreWords = board_score != nullptr;
+    searchBoard(state);
+    word_indexes.assign(state.resultWordIndexes.begin(), state.resultWordIndexes.end());
+    if(board_score)
+    {
+        *board_score = state.totalScore;
+    }
+    return true;
+}
+
+//Follow the short paths of a board through the trie the same way the search does, stopping at maxPathCells cells
+void c_boggle::boundFromPath(c_solve_state &state, int *pathPositions, int pathLength, int currentNode, int maxPathCells, int &wordCount) const
+{
+    if(!subtreeIsPossible(state, currentNode))
+    {
+        return;
+    }
+    if(pathLength == maxPathCells) //Every word below here is counted once the nodes reached by other paths are known, so none is counted twice
+    {
+        state.boundNodes.push_back(currentNode);
+        return;
+    }
+    int wordIndex = trieNodes[currentNode].wordIndex;
+    if(wordIndex != -1 && state.wordFoundGeneration[wordIndex] != state.solveGeneration)
+    {
+        state.wordFoundGeneration[wordIndex] = state.solveGeneration;
+        wordCount++;
+    }
+    const c_board_adjacency &adjacency = *state.adjacency;
+    int lastPosition = pathPositions[pathLength - 1];
+    for(int neighbourIndex = adjacency.neighbourStarts[lastPosition]; neighbourIndex < adjacency.neighbourStarts[lastPosition + 1]; neighbourIndex++)
+    {
+        int neighbourPosition = adjacency.neighbourPositions[neighbourIndex];
+        int neighbourSymbol = state.boardSymbols[neighbourPosition];
+        if(neighbourSymbol < 0 || std::find(pathPositions, pathPositions + pathLength, neighbourPosition) != pathPositions + pathLength)
+        {
+            continue;
+        }
+        int childNode = trieChild(trieNodes, currentNode, neighbourSymbol);
+        if(childNode != -1)
+        {
+            pathPositions[pathLength] = neighbourPosition;
+            boundFromPath(state, pathPositions, pathLength + 1, childNode, maxPathCells, wordCount);
+        }
+    }
+}
+
+int c_boggle::word_count_upper_bound(c_solve_workspace &workspace, int board_width, int board_height, const char *board_letters, int path_cells) const
+{
+    c_solve_state &state = workspace.state;
+    c_board_status boardStatus = beginSolve(state, board_width, board_height, board_letters);
+    reportBoardStatus(boardStatus);
+    if(boardStatus != board_valid || trieNodeCount == 0)
+    {
+        return 0;
+    }
+    int pathPositions[8];
+    int maxPathCells = std::max(1, std::min(path_cells, 8));
+    int wordCount = 0;
+    state.boundNodes.clear();
+    for(int firstPosition = 0; firstPosition < state.board_size; firstPosition++)
+    {
+        int firstSymbol = state.boardSymbols[firstPosition];
+        int firstNode = firstSymbol < 0 ? -1 : trieChild(trieNodes, 0, firstSymbol);
+        if(firstNode != -1)
+        {
+            pathPositions[0] = firstPosition;
+            boundFromPath(state, pathPositions, 1, firstNode, maxPathCells, wordCount);
+        }
+    }
+    std::sort(state.boundNodes.begin(), state.boundNodes.end());
+    state.boundNodes.erase(std::unique(state.boundNodes.begin(), state.boundNodes.end()), state.boundNodes.end());
+    for(int boundNode : state.boundNodes)
+    {
+        wordCount += trieSubtreeWordCounts[boundNode];
+    }
+    return wordCount;
+}
+
+//Solve a batch of boards on a set of worker threads; each worker claims the next unsolved board from a shared counter
+//so that boards which take longer to solve don't hold up the rest, and writes its results into that board's slot
+std::vector<std::vector<std::string>> c_boggle::solve_boards(const c_boggle_board *boards, size_t board_count, int thread_count, c_boggle_solve_stats *solve_stats)
+{
+    std::vector<std::vector<std::string>> allResults(board_count); //One result list per board, in board order
+    std::atomic<size_t> nextBoardIndex(0); //Index of the next board that hasn't been claimed by a worker
+
+    if(thread_count <= 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    thread_count = std::min<size_t>(thread_count, board_count);
+    std::vector<c_boggle_solve_stats> workerStats(thread_count); //Counters added up by each worker, combined once all boards are done
+
+    auto solveWorker = [&] (int workerIndex)
+    {
+        c_solve_state workerState; //Scratch state owned by this worker and reused for every board it solves
+        for(size_t boardIndex = nextBoardIndex++; boardIndex < board_count; boardIndex = nextBoardIndex++)
+        {
+            const c_boggle_board &board = boards[boardIndex];
+            allResults[boardIndex] = wordsFromIndexes(solveWithState(workerState, board.board_width, board.board_height, board.board_letters));
+            if(solve_stats)
+            {
+                workerStats[workerIndex].add(workerState.stats);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(int workerIndex = 1; workerIndex < thread_count; workerIndex++)
+    {
+        workers.emplace_back(solveWorker, workerIndex);
+    }
+    solveWorker(0); //The calling thread works too instead of waiting idle
+    for(std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    if(solve_stats)
+    {
+        *solve_stats = c_boggle_solve_stats();
+        for(const c_boggle_solve_stats &stats : workerStats)
+        {
+            solve_stats->add(stats);
+        }
+    }
+    return allResults;
+}
+
+
+//Solve one board on a work-stealing pool of threads; the board is split into a task per start cell, and cells whose letter
+//starts an above average share of the legal words are split further into a task per second cell. Every thread keeps its own
+//found words, which are merged once all tasks are done.
+std::vector<std::string> c_boggle::solve_board_parallel(int board_width, int board_height, const char *board_letters, int thread_count, c_boggle_solve_stats *solve_stats)
+{
+    if(thread_count <= 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if(solve_stats)
+    {
+        *solve_stats = c_boggle_solve_stats();
+    }
+    std::vector<c_solve_state> workerStates(thread_count); //Scratch state and found words for each thread
+    c_board_status boardStatus = beginSolve(workerStates[0], board_width, board_height, board_letters);
+    if(boardStatus != board_valid)
+    {
+        reportBoardStatus(boardStatus);
+        return {};
+    }
+    for(int workerIndex = 1; workerIndex < thread_count; workerIndex++) //The same board, so these can't fail
+    {
+        beginSolve(workerStates[workerIndex], board_width, board_height, board_letters);
+    }
+    if(trieNodeCount == 0) //No legal words have been set
+    {
+        return {};
+    }
+
+    //Build the tasks, handing out contiguous runs of start cells so each thread starts on its own part of the board
+    std::vector<c_task_queue> taskQueues(thread_count);
+    int board_size = board_width * board_height;
+    int hotWordCount = 2 * trieSubtreeWordCounts[0] / alphabet->symbolCount; //Start symbols with more words than twice an even share get split up
+    for(int firstPosition = 0; firstPosition < board_size; firstPosition++)
+    {
+        std::deque<c_search_task> &tasks = taskQueues[(long long)firstPosition * thread_count / board_size].tasks;
+        int firstSymbol = workerStates[0].boardSymbols[firstPosition];
+        int firstNode = (firstSymbol < 0) ? -1 : trieChild(trieNodes, 0, firstSymbol);
+        if(firstNode == -1)
+        {
+            continue;
+        }
+        if(thread_count == 1 || trieSubtreeWordCounts[firstNode] <= hotWordCount)
+        {
+            tasks.push_back({firstPosition, -1});
+            continue;
+        }
+
+        const c_board_adjacency &adjacency = *workerStates[0].adjacency;
+        for(int neighbourIndex = adjacency.neighbourStarts[firstPosition]; neighbourIndex < adjacency.neighbourStarts[firstPosition + 1]; neighbourIndex++)
+        {
+            tasks.push_back({firstPosition, adjacency.neighbourPositions[neighbourIndex]});
+        }
+    }
+
+    //Take a task from the back of our own queue, or steal one from the front of another thread's queue once ours is empty;
+    //tasks never create more tasks, so a thread can stop as soon as it finds every queue empty
+    auto takeTask = [&] (int workerIndex, c_search_task &task)
+    {
+        for(int queueOffset = 0; queueOffset < thread_count; queueOffset++)
+        {
+            c_task_queue &queue = taskQueues[(workerIndex + queueOffset) % thread_count];
+            std::lock_guard<std::mutex> queueLock(queue.queueMutex);
+            if(!queue.tasks.empty())
+            {
+                if(queueOffset == 0)
+                {
+                    task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                }
+                else
+                {
+                    task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto solveWorker = [&] (int workerIndex)
+    {
+        c_search_task task;
+        while(takeTask(workerIndex, task))
+        {
+            searchFromPath(workerStates[workerIndex], task.firstPosition, task.secondPosition);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(int workerIndex = 1; workerIndex < thread_count; workerIndex++)
+    {
+        workers.emplace_back(solveWorker, workerIndex);
+    }
+    solveWorker(0); //The calling thread works too instead of waiting idle
+    for(std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    //Combine the words found by each thread, dropping words found by more than one thread
+    std::vector<int> mergedWordIndexes;
+    for(c_solve_state &workerState : workerStates)
+    {
+        mergedWordIndexes.insert(mergedWordIndexes.end(), workerState.resultWordIndexes.begin(), workerState.resultWordIndexes.end());
+    }
+    std::sort(mergedWordIndexes.begin(), mergedWordIndexes.end());
+    mergedWordIndexes.erase(std::unique(mergedWordIndexes.begin(), mergedWordIndexes.end()), mergedWordIndexes.end());
+
+    if(solve_stats) //Each thread counted its own part of the one board
+    {
+        for(c_solve_state &workerState : workerStates)
+        {
+            solve_stats->add(workerState.stats);
+        }
+        solve_stats->boards_solved = std::min<uint64_t>(solve_stats->boards_solved, 1);
+    }
+    return wordsFromIndexes(mergedWordIndexes);
+}
+
+//Count a path spelling a word in or out, moving the word onto or off the found words, the board's score and the counts of
+//found words by length when its count leaves or reaches zero
+void c_boggle::countWordPath(int wordIndex, int pathCountChange)
+{
+    c_solve_state &state = editableBoard.state;
+    uint32_t &pathCount = editableBoard.wordPathCounts[wordIndex];
+    std::vector<int> &foundLetterCounts = editableBoard.foundLetterCounts;
+    if(pathCountChange > 0 && pathCount++ == 0)
+    {
+        editableBoard.foundWordSlots[wordIndex] = state.resultWordIndexes.size();
+        state.resultWordIndexes.push_back(wordIndex);
+        state.totalScore += wordScore(wordIndex);
+        int wordLetters = wordLetterCount(wordIndex);
+        if(foundLetterCounts.size() <= (size_t)wordLetters)
+        {
+            foundLetterCounts.resize(wordLetters + 1, 0);
+        }
+        foundLetterCounts[wordLetters]++;
+    }
+    else if(pathCountChange < 0 && --pathCount == 0) //Fill the word's slot with the last found word
+    {
+        state.totalScore -= wordScore(wordIndex);
+        foundLetterCounts[wordLetterCount(wordIndex)]--;
+        while(!foundLetterCounts.empty() && foundLetterCounts.back() == 0) //Keep the longest found word at the end
+        {
+            foundLetterCounts.pop_back();
+        }
+        int lastWordIndex = state.resultWordIndexes.back();
+        editableBoard.foundWordSlots[lastWordIndex] = editableBoard.foundWordSlots[wordIndex];
+        state.resultWordIndexes[editableBoard.foundWordSlots[wordIndex]] = lastWordIndex;
+        state.resultWordIndexes.pop_back();
+        editableBoard.foundWordSlots[wordIndex] = -1;
+    }
+}
+
+int c_boggle::addBoardPath(int position, int node, int parent)
+{
+    std::vector<c_board_path> &paths = editableBoard.paths;
+    int newPath = editableBoard.firstFreePath;
+    if(newPath != -1)
+    {
+        editableBoard.firstFreePath = paths[newPath].nextSibling;
+    }
+    else
+    {
+        newPath = paths.size();
+        paths.emplace_back();
+    }
+
+    c_board_path &boardPath = paths[newPath];
+    boardPath.position = position;
+    boardPath.wordIndex = trieNodes[node].wordIndex;
+    boardPath.trieChildLetters = trieNodes[node].childLetters;
+    boardPath.trieFirstChild = trieNodes[node].firstChild;
+    boardPath.parent = parent;
+    boardPath.firstChild = -1;
+    boardPath.nextSibling = -1;
+    if(parent != -1)
+    {
+        boardPath.nextSibling = paths[parent].firstChild;
+        paths[parent].firstChild = newPath;
+    }
+    boardPath.previousAtCell = -1;
+    boardPath.nextAtCell = editableBoard.cellPaths[position];
+    if(boardPath.nextAtCell != -1)
+    {
+        paths[boardPath.nextAtCell].previousAtCell = newPath;
+    }
+    editableBoard.cellPaths[position] = newPath;
+
+    if(boardPath.wordIndex != -1)
+    {
+        countWordPath(boardPath.wordIndex, 1);
+    }
+    return newPath;
+}
+
+void c_boggle::removeBoardPath(int path)
+{
+    std::vector<c_board_path> &paths = editableBoard.paths;
+    int parent = paths[path].parent;
+    if(parent != -1) //Take the path off its parent's children
+    {
+        int *siblingLink = &paths[parent].firstChild;
+        while(*siblingLink != path)
+        {
+            siblingLink = &paths[*siblingLink].nextSibling;
+        }
+        *siblingLink = paths[path].nextSibling;
+    }
+
+    std::vector<int> &removalStack = editableBoard.pathWork;
+    removalStack.assign(1, path);
+    while(!removalStack.empty())
+    {
+        int removedPath = removalStack.back();
+        removalStack.pop_back();
+        c_board_path &boardPath = paths[removedPath];
+        for(int childPath = boardPath.firstChild; childPath != -1; childPath = paths[childPath].nextSibling)
+        {
+            removalStack.push_back(childPath);
+        }
+        if(boardPath.previousAtCell != -1)
+        {
+            paths[boardPath.previousAtCell].nextAtCell = boardPath.nextAtCell;
+        }
+        else
+        {
+            editableBoard.cellPaths[boardPath.position] = boardPath.nextAtCell;
+        }
+        if(boardPath.nextAtCell != -1)
+        {
+            paths[boardPath.nextAtCell].previousAtCell = boardPath.previousAtCell;
+        }
+        if(boardPath.wordIndex != -1)
+        {
+            countWordPath(boardPath.wordIndex, -1);
+        }
+        boardPath.nextSibling = editableBoard.firstFreePath;
+        editableBoard.firstFreePath = removedPath;
+    }
+}
+
+//Same search as searchPaths, starting from a path that is already on the board instead of a start cell, and adding every
+//path it finds to the board instead of only the words. The cells of the starting path are marked as visited first, so
+//none of the new paths can go back through them.
+void c_boggle::growBoardPaths(int path)
+{
+    c_solve_state &state = editableBoard.state;
+    const int *neighbourStarts = state.adjacency->neighbourStarts.data();
+    const int *neighbourPositions = state.adjacency->neighbourPositions.data();
+    const int8_t *boardSymbols = state.boardSymbols.data();
+    std::vector<c_board_path> &paths = editableBoard.paths;
+    c_growth_frame *growthStack = editableBoard.growthStack.data();
+    c_visited_bitset visitedCells = {state.visitedCellWords.data()};
+
+    for(int pathCell = path; pathCell != -1; pathCell = paths[pathCell].parent)
+    {
+        visitedCells.set(paths[pathCell].position);
+    }
+    int startPosition = paths[path].position;
+    growthStack[0] = {path, neighbourStarts[startPosition], neighbourStarts[startPosition + 1]};
+    int stackLength = 1;
+
+    while(stackLength > 0)
+    {
+        c_growth_frame &currentFrame = growthStack[stackLength - 1];
+        if(currentFrame.neighbourIndex == currentFrame.neighbourEnd) //Every path through this letter has been added
+        {
+            if(stackLength > 1) //The starting path's cells are cleared below
+            {
+                visitedCells.clear(paths[currentFrame.path].position);
+            }
+            stackLength--;
+            continue;
+        }
+
+        int nextLetterPosition = neighbourPositions[currentFrame.neighbourIndex++];
+        int nextSymbol = boardSymbols[nextLetterPosition];
+        if(visitedCells.test(nextLetterPosition) || nextSymbol < 0)
+        {
+            continue;
+        }
+        int nextNode = boardPathChild(currentFrame.path, nextSymbol);
+        if(nextNode == -1)
+        {
+            continue;
+        }
+        int nextPath = addBoardPath(nextLetterPosition, nextNode, currentFrame.path); //May move paths, but the frame only holds indexes
+        visitedCells.set(nextLetterPosition);
+        growthStack[stackLength++] = {nextPath, neighbourStarts[nextLetterPosition], neighbourStarts[nextLetterPosition + 1]};
+    }
+
+    for(int pathCell = path; pathCell != -1; pathCell = paths[pathCell].parent)
+    {
+        visitedCells.clear(paths[pathCell].position);
+    }
+}
+
+bool c_boggle::set_board(int board_width, int board_height, const char *board_letters)
+{
+    c_solve_state &state = editableBoard.state;
+    if((size_t)legalWordCount != editableBoard.wordPathCounts.size()) //First board since the dictionary was set
+    {
+        editableBoard.wordPathCounts.assign(legalWordCount, 0);
+        editableBoard.foundWordSlots.assign(legalWordCount, -1);
+        state.resultWordIndexes.clear();
+    }
+    for(int wordIndex : state.resultWordIndexes) //Only the words of the last board have counts to clear
+    {
+        editableBoard.wordPathCounts[wordIndex] = 0;
+        editableBoard.foundWordSlots[wordIndex] = -1;
+    }
+    editableBoard.paths.clear();
+    editableBoard.firstFreePath = -1;
+    editableBoard.foundLetterCounts.clear();
+    c_board_status boardStatus = beginSolve(state, board_width, board_height, board_letters);
+    if(boardStatus != board_valid)
+    {
+        reportBoardStatus(boardStatus);
+        state.board_size = 0; //Nothing to edit until a valid board is set
+        return false;
+    }
+
+    //Paths aren't filtered by the symbols on the board, since a path ruled out now could be needed once a cell changes
+    state.visitedCellWords.assign((state.board_size + 63) / 64, 0);
+    editableBoard.growthStack.resize(maxWordLength + 1);
+    editableBoard.cellPaths.assign(state.board_size, -1);
+    for(int firstPosition = 0; firstPosition < state.board_size && trieNodeCount != 0; firstPosition++)
+    {
+        int firstSymbol = state.boardSymbols[firstPosition];
+        int firstNode = (firstSymbol < 0) ? -1 : trieChild(trieNodes, 0, firstSymbol);
+        if(firstNode != -1)
+        {
+            growBoardPaths(addBoardPath(firstPosition, firstNode, -1));
+        }
+    }
+    return true;
+}
+
+bool c_boggle::update_cell(int cell_position, const char *cell_letters)
+{
+    c_solve_state &state = editableBoard.state;
+    if(cell_position < 0 || cell_position >= state.board_size)
+    {
+        std::cout << "Cell position is not on the board!" << std::endl;
+        return false;
+    }
+    size_t textLength = std::strlen(cell_letters), symbolLength;
+    int newSymbol = matchSymbol(*alphabet, cell_letters, textLength, symbolLength);
+    if(newSymbol == -1 || symbolLength != textLength)
+    {
+        std::cout << "Cell letters are not a symbol of the alphabet!" << std::endl;
+        return false;
+    }
+    if(newSymbol == state.boardSymbols[cell_position])
+    {
+        return true;
+    }
+    state.boardSymbols[cell_position] = newSymbol;
+    if(trieNodeCount == 0)
+    {
+        return true;
+    }
+
+    //Remove every path through the cell; a path can only pass through a cell once, so these are exactly the paths ending at
+    //the cell and the longer paths starting with them. Paths that avoid the cell spell the same words as before and stay.
+    while(editableBoard.cellPaths[cell_position] != -1)
+    {
+        removeBoardPath(editableBoard.cellPaths[cell_position]);
+    }
+
+    //Every new path through the cell is a path ending next to it with the new symbol added, or starts at the cell; find the
+    //neighbouring paths that can take the symbol before adding any, since the new paths also end next to the cell
+    const c_board_adjacency &adjacency = *state.adjacency;
+    std::vector<int> &growthParents = editableBoard.pathWork;
+    growthParents.clear();
+    for(int neighbourIndex = adjacency.neighbourStarts[cell_position]; neighbourIndex < adjacency.neighbourStarts[cell_position + 1]; neighbourIndex++)
+    {
+        for(int neighbourPath = editableBoard.cellPaths[adjacency.neighbourPositions[neighbourIndex]]; neighbourPath != -1; neighbourPath = editableBoard.paths[neighbourPath].nextAtCell)
+        {
+            if((editableBoard.paths[neighbourPath].trieChildLetters >> newSymbol) & 1)
+            {
+                growthParents.push_back(neighbourPath);
+            }
+        }
+    }
+    int firstNode = trieChild(trieNodes, 0, newSymbol);
+    if(firstNode != -1)
+    {
+        growBoardPaths(addBoardPath(cell_position, firstNode, -1));
+    }
+    for(int parentPath : growthParents)
+    {
+        growBoardPaths(addBoardPath(cell_position, boardPathChild(parentPath, newSymbol), parentPath));
+    }
+    return true;
+}
+
+std::vector<int> c_boggle::board_word_indexes() const
+{
+    std::vector<int> wordIndexes = editableBoard.state.resultWordIndexes;
+    std::sort(wordIndexes.begin(), wordIndexes.end());
+    return wordIndexes;
+}
+
+std::vector<std::string> c_boggle::board_words() const
+{
+    return wordsFromIndexes(board_word_indexes());
+}
+
+int c_boggle::board_word_count() const
+{
+    return (int)editableBoard.state.resultWordIndexes.size();
+}
+
+int c_boggle::board_score() const
+{
+    return editableBoard.state.totalScore;
+}
+
+int c_boggle::board_longest_word() const
+{
+    return editableBoard.foundLetterCounts.empty() ? 0 : (int)editableBoard.foundLetterCounts.size() - 1;
+}
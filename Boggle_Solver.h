@@ -0,0 +1,740 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Solver
+//Program Description: Declaration of c_boggle, which given a dictionary list of legal playable words, a game
+//board's width and height, and a list of letters equal in size to the board's width times height, returns a list
+//of all words from the given dictionary that can be "solved for" using standard boggle rules as described at
+//https://en.wikipedia.org/wiki/Boggle
+//The solver itself is in Boggle_Solver.cpp, and the example program in Boggle_Solver_Main.cpp; build with
+//g++ -std=c++17 -O2 -pthread Boggle_Solver.cpp Boggle_Solver_Main.cpp -o Boggle_Solver
+//and the tests in Boggle_Solver_Test.cpp, which exit with 1 if any check fails, with
+//g++ -std=c++17 -O2 -pthread Boggle_Solver.cpp Boggle_Solver_Test.cpp -o Boggle_Solver_Test
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#ifndef BOGGLE_SOLVER_H
+#define BOGGLE_SOLVER_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <istream>
+#include <mutex>
+#include <deque>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <chrono>
+
+//Build every file with BOGGLE_SOLVER_STATS defined to 1 to count what the search does on each board; otherwise the
+//counters are compiled out and cost nothing
+#ifndef BOGGLE_SOLVER_STATS
+#define BOGGLE_SOLVER_STATS 0
+#endif
+
+//Boards are read with AVX2 or SSE4.2 kernels when the processor has them, chosen at run time; build with BOGGLE_SOLVER_SIMD
+//defined to 0 to always use the plain C++ versions, for example to check that both give the same results
+#ifndef BOGGLE_SOLVER_SIMD
+#define BOGGLE_SOLVER_SIMD 1
+#endif
+
+//Counters describing the search of one or more boards, filled in when BOGGLE_SOLVER_STATS is enabled
+struct c_boggle_solve_stats
+{
+    uint64_t boards_solved = 0; //Number of boards the counters cover
+    uint64_t nodes_visited = 0; //Letters added to a search path, including the start letters
+    uint64_t prefix_probes = 0; //Trie lookups of a letter following a search path
+    uint64_t dead_end_prunes = 0; //Lookups that found no legal word starting with the path, ending that branch of the search
+    uint64_t word_checks = 0; //Paths that spelled a legal word and were checked against the words already found
+    int max_depth = 0; //Length of the longest path searched
+    std::vector<uint64_t> start_cell_nanoseconds; //Time spent searching paths from each start cell, by board position
+
+    void add(const c_boggle_solve_stats &other) //Adds the counters of other to these
+    {
+        boards_solved += other.boards_solved;
+        nodes_visited += other.nodes_visited;
+        prefix_probes += other.prefix_probes;
+        dead_end_prunes += other.dead_end_prunes;
+        word_checks += other.word_checks;
+        max_depth = std::max(max_depth, other.max_depth);
+        if(start_cell_nanoseconds.size() < other.start_cell_nanoseconds.size())
+        {
+            start_cell_nanoseconds.resize(other.start_cell_nanoseconds.size(), 0);
+        }
+        for(size_t cellPosition = 0; cellPosition < other.start_cell_nanoseconds.size(); cellPosition++)
+        {
+            start_cell_nanoseconds[cellPosition] += other.start_cell_nanoseconds[cellPosition];
+        }
+    }
+};
+
+//One board to be solved by c_boggle::solve_boards
+struct c_boggle_board
+{
+    int board_width; //Width of the board
+    int board_height; //Height of the board
+    const char *board_letters; //board_width*board_height cells in row major order
+};
+
+//A word found by c_boggle::solve_board_scored
+struct c_boggle_found_word
+{
+    int word_index; //Alphabetical index of the word, which c_boggle::legal_word turns into its text
+    int score; //Points for the word under standard Boggle scoring
+    uint32_t path_offset; //Start of the word's path in c_boggle_scored_board::path_positions
+    uint32_t path_length; //Number of cells in the word's path
+};
+
+//Words found on one board by c_boggle::solve_board_scored, with their scores and the cells of a path spelling each of them
+struct c_boggle_scored_board
+{
+    std::vector<c_boggle_found_word> words; //Words found on the board, in alphabetical order
+    std::vector<uint8_t> path_positions; //Board positions of the first path found for each word, from its first cell to its last
+    int total_score = 0; //Sum of the scores of all words found
+};
+
+class c_boggle
+{
+private:
+    static const int maxAlphabetSize = 32; //Most symbols an alphabet can have, so a set of symbols fits in 32 bits
+    static const int maxSymbolLength = 7; //Most bytes of text in one symbol
+
+    //The symbols that board cells and words are made of, numbered by their position; usually the letters 'a' to 'z', but a
+    //symbol can also be a tile with several letters, such as the "qu" of a retail Boggle game, or a UTF-8 character
+    struct c_symbol_alphabet
+    {
+        uint32_t symbolCount; //Number of symbols
+        char symbolTexts[maxAlphabetSize][maxSymbolLength + 1]; //Text of each symbol, lowercase and nul terminated
+    };
+
+    //A node in the prefix trie of legal words, which are spelled as symbol codes. The children of a node are stored next to each
+    //other in symbol order, so a node only needs a bit per symbol saying which children exist and the index of the first one;
+    //the child for a symbol is found by counting the children for earlier symbols
+    struct c_trie_node
+    {
+        uint32_t childLetters; //Bit i is set if the node has a child for symbol i
+        int32_t firstChild; //Index of the node's first child
+        int32_t wordIndex; //Alphabetical index of the legal word spelled by the path from the root to this node, or -1 if it isn't a word
+        uint32_t subtreeLetters; //Bit i is set if every word at or below this node contains symbol i
+    };
+
+    //A node of the trie while words are still being added; since the final number of children isn't known yet, they are
+    //kept as a list sorted by symbol
+    struct c_build_trie_node
+    {
+        int32_t firstChild; //Index of the child with the lowest symbol, or -1
+        int32_t nextSibling; //Index of the parent's child with the next higher symbol, or -1
+        int8_t letter; //Symbol leading to this node from its parent
+        bool isWord; //True if the path from the root to this node spells a legal word
+    };
+
+    //Neighbours of every cell for one board shape, in compressed sparse row form: the neighbours of cell p are
+    //neighbourPositions[neighbourStarts[p]] up to but not including neighbourPositions[neighbourStarts[p + 1]]
+    struct c_board_adjacency
+    {
+        int board_width, board_height; //Shape of the board this table was built for
+        std::vector<int> neighbourStarts; //board_width*board_height + 1 offsets into neighbourPositions
+        std::vector<int> neighbourPositions; //Up to 8 neighbour positions per cell
+    };
+
+    //Neighbours of every cell for a board shape known at compile time, as one 64-bit mask of neighbour positions per cell;
+    //built as a constant, so the specialized solvers read it from static data
+    template <int t_board_width, int t_board_height>
+    struct c_fixed_board_adjacency
+    {
+        uint64_t neighbourMasks[t_board_width * t_board_height];
+
+        constexpr c_fixed_board_adjacency() : neighbourMasks()
+        {
+            for(int currentPosition = 0; currentPosition < t_board_width * t_board_height; currentPosition++)
+            {
+                int currentRow = currentPosition / t_board_width, currentColumn = currentPosition % t_board_width;
+                for(int rowOffset = -1; rowOffset <= 1; rowOffset++)
+                {
+                    for(int columnOffset = -1; columnOffset <= 1; columnOffset++)
+                    {
+                        int neighbourRow = currentRow + rowOffset, neighbourColumn = currentColumn + columnOffset;
+                        if((rowOffset != 0 || columnOffset != 0) && neighbourRow >= 0 && neighbourRow < t_board_height
+                            && neighbourColumn >= 0 && neighbourColumn < t_board_width)
+                        {
+                            neighbourMasks[currentPosition] |= uint64_t(1) << (neighbourRow * t_board_width + neighbourColumn);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    //One letter of a path on a fixed size board; the neighbours still to try are kept as a mask instead of a table index
+    struct c_fixed_search_frame
+    {
+        uint64_t remainingNeighbours; //Neighbour positions of this letter that haven't been tried yet
+        int position; //Board position of this letter
+        int node; //Trie node of the path up to and including this letter
+    };
+
+    //One letter of the path being searched, kept on an explicit stack instead of the call stack
+    struct c_search_frame
+    {
+        int position; //Board position of this letter
+        int node; //Trie node of the path up to and including this letter
+        int neighbourIndex; //Next entry of the neighbour table to try from this letter
+        int neighbourEnd; //End of this letter's neighbours in the neighbour table
+    };
+
+    //Visited set for boards of up to 64 cells, kept in a single register
+    struct c_visited_mask
+    {
+        uint64_t cellBits = 0;
+        bool test(int position) const {return (cellBits >> position) & 1;}
+        void set(int position) {cellBits |= uint64_t(1) << position;}
+        void clear(int position) {cellBits &= ~(uint64_t(1) << position);}
+    };
+
+    //Visited set for larger boards, as a bitset of 64-bit words owned by the solve state
+    struct c_visited_bitset
+    {
+        uint64_t *cellWords;
+        bool test(int position) const {return (cellWords[position >> 6] >> (position & 63)) & 1;}
+        void set(int position) {cellWords[position >> 6] |= uint64_t(1) << (position & 63);}
+        void clear(int position) {cellWords[position >> 6] &= ~(uint64_t(1) << (position & 63));}
+    };
+
+    //Search counters for one call of a search loop, kept in locals so the loop doesn't write through the solve state, and
+    //added to the state's stats when the loop finishes; every member compiles to nothing unless BOGGLE_SOLVER_STATS is enabled
+    struct c_search_counters
+    {
+#if BOGGLE_SOLVER_STATS
+        uint64_t nodesVisited = 0, prefixProbes = 0, deadEndPrunes = 0, wordChecks = 0;
+        int maxDepth = 0;
+        void countNode(int pathLength) {nodesVisited++; maxDepth = std::max(maxDepth, pathLength);}
+        void countProbe(int foundNode) {prefixProbes++; deadEndPrunes += (foundNode == -1);}
+        void countWordCheck() {wordChecks++;}
+        void addTo(c_boggle_solve_stats &stats) const
+        {
+            stats.nodes_visited += nodesVisited;
+            stats.prefix_probes += prefixProbes;
+            stats.dead_end_prunes += deadEndPrunes;
+            stats.word_checks += wordChecks;
+            stats.max_depth = std::max(stats.max_depth, maxDepth);
+        }
+#else
+        void countNode(int) {}
+        void countProbe(int) {}
+        void countWordCheck() {}
+        void addTo(c_boggle_solve_stats &) const {}
+#endif
+    };
+
+    //Adds the time from its construction to its destruction to the search time of a start cell, if BOGGLE_SOLVER_STATS is enabled
+    struct c_start_cell_timer
+    {
+#if BOGGLE_SOLVER_STATS
+        uint64_t &cellNanoseconds;
+        std::chrono::steady_clock::time_point startTime;
+        c_start_cell_timer(c_boggle_solve_stats &stats, int cellPosition) : cellNanoseconds(stats.start_cell_nanoseconds[cellPosition]), startTime(std::chrono::steady_clock::now()) {}
+        ~c_start_cell_timer() {cellNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();}
+#else
+        c_start_cell_timer(c_boggle_solve_stats &, int) {}
+#endif
+    };
+
+    //Result of checking a board against its text; beginSolve only returns it, and the caller decides whether to report it
+    enum c_board_status
+    {
+        board_valid,
+        board_size_invalid,     //The width or height isn't positive, or the board has more cells than an int can count
+        board_letters_mismatch  //The text doesn't split into exactly board_width*board_height cells
+    };
+
+    //Everything that changes while solving a board; each thread solving boards needs its own copy, while the trie is shared
+    struct c_solve_state
+    {
+        std::vector<int> resultWordIndexes; //Indexes of the words found on the board, in the order they were found until the solve finishes and sorts them
+        std::vector<uint64_t> visitedCellWords; //Storage for the visited set of boards larger than 64 cells
+        std::vector<c_search_frame> pathStack; //Storage for the search stack of boards larger than 64 cells
+        std::vector<unsigned int> wordFoundGeneration; //Per word, the solve generation in which it was last found; a word is already found if this equals solveGeneration
+        unsigned int solveGeneration = 0; //Incremented at the start of each solve so found words from previous boards don't need to be cleared
+        int working_board_width = 0, working_board_height = 0, board_size = 0; //Dimensions of the board being solved
+        std::vector<int8_t> boardSymbols; //Symbol code of every cell of the current board, or -1 for a cell that isn't in the alphabet
+        std::shared_ptr<const c_board_adjacency> adjacency; //Neighbour table for the shape of the board being solved
+        c_boggle_solve_stats stats; //Counters for the board being solved; only kept up to date when BOGGLE_SOLVER_STATS is enabled
+        uint32_t boardLetterMask; //Bit i is set if the board being solved has symbol i
+        bool filterSubtrees; //True if the board is missing a symbol, so subtrees needing that symbol can be skipped
+        bool scoreWords = false; //True to add up the score of every word found in totalScore
+        bool recordPaths = false; //True to record every word found, with its score and path, in foundWords
+        int totalScore; //Sum of the scores of the words found so far, if scoreWords is set
+        std::vector<c_boggle_found_word> foundWords; //Words found so far, in the order they were found, if recordPaths is set
+        std::vector<uint8_t> foundPathPositions; //Positions of the paths of foundWords, if recordPaths is set
+        std::vector<int> boundNodes; //Trie nodes reached by the short paths of word_count_upper_bound
+        bool boardValid = false; //True once beginSolve has checked the board letters against the board size
+    };
+
+    //A path on the editable board that spells the start of a legal word. The paths form a tree, the children of a path being
+    //the paths one cell longer, and every path is also on a list of the paths ending at its last cell
+    struct c_board_path
+    {
+        int32_t position; //Board position of the path's last cell
+        int32_t wordIndex; //Legal word the path spells, or -1
+        uint32_t trieChildLetters; //childLetters and firstChild of the trie node the path spells, copied so that extending the path
+        int32_t trieFirstChild;    //by a symbol doesn't need to read the trie until the new node
+        int32_t parent; //The path without its last cell, or -1 for a path of one cell
+        int32_t firstChild; //First path one cell longer than this one, or -1
+        int32_t nextSibling; //Next child of the same parent; for an unused path, the next unused path
+        int32_t previousAtCell, nextAtCell; //Neighbours on the list of paths ending at the same cell, or -1
+    };
+
+    //One path being extended by growBoardPaths, and the neighbours of its last cell still to try
+    struct c_growth_frame
+    {
+        int path;
+        int neighbourIndex;
+        int neighbourEnd;
+    };
+
+    //A board kept between calls so that single cells can be changed without solving the whole board again. Every path that
+    //spells the start of a legal word is kept, so changing a cell only removes the paths through it and grows new ones from
+    //the paths ending next to it; a word stays on the board for as long as at least one kept path spells it
+    struct c_editable_board
+    {
+        c_solve_state state; //Cell symbols, neighbour table and visited set; state.resultWordIndexes holds the words found, unsorted
+        std::vector<c_board_path> paths; //Every path kept for the board, plus unused entries
+        int firstFreePath = -1; //First unused entry of paths, or -1
+        std::vector<int> cellPaths; //Per position, the first path ending there, or -1
+        std::vector<uint32_t> wordPathCounts; //Per legal word, the number of kept paths that spell it
+        std::vector<int> foundWordSlots; //Per legal word, its position in state.resultWordIndexes, or -1 if it has no paths
+        std::vector<int> foundLetterCounts; //Per word length in letters, how many found words are that long; trimmed so the last entry is the longest word
+        std::vector<c_growth_frame> growthStack; //Search stack of growBoardPaths
+        std::vector<int> pathWork; //Paths waiting to be removed or grown from
+    };
+
+    //A piece of a parallel solve: every path starting at firstPosition, or only the paths continuing to secondPosition if it isn't -1
+    struct c_search_task
+    {
+        int firstPosition;
+        int secondPosition;
+    };
+
+    //Work queue owned by one thread of a parallel solve; the owner takes tasks from the back, idle threads steal from the front
+    struct c_task_queue
+    {
+        std::deque<c_search_task> tasks;
+        std::mutex queueMutex;
+    };
+
+    //Header at the start of a compiled dictionary, including the alphabet its words are spelled with; the trie nodes, subtree
+    //word counts, word offsets and word letters follow in that order, each starting on an 8 byte boundary. Everything is stored as indexes, so a dictionary file can be mapped
+    //into memory and solved against as is, and a dictionary built in memory uses exactly the same layout.
+    struct c_dictionary_file_header
+    {
+        char magic[8]; //Always "BOGLDICT"
+        uint32_t formatVersion; //Changes whenever the layout of the file changes
+        uint32_t trieNodeSize; //Size of one trie node, so a file written by a build with a different node layout is rejected
+        uint32_t trieNodeCount; //Number of trie nodes
+        uint32_t legalWordCount; //Number of legal words
+        uint32_t maxWordLength; //Number of symbols in the longest legal word
+        uint32_t unused; //Padding, always 0
+        uint64_t wordLettersSize; //Total number of bytes of text in all legal words
+        c_symbol_alphabet alphabet; //Symbols the words are spelled with
+    };
+
+    c_symbol_alphabet buildAlphabet = defaultAlphabet(); //Alphabet for the next dictionary built from a word list, set by set_alphabet
+    std::vector<c_build_trie_node> buildTrieNodes; //Trie of the words added since beginLegalWords; emptied by finishLegalWords
+    size_t buildWordLettersSize = 0; //Total number of letters in the words added so far
+    std::vector<uint64_t> builtDictionary; //Arena holding a dictionary built from a word list, in the same layout as a dictionary file
+    void *mappedDictionary = nullptr; //Memory mapping of a dictionary loaded by load_dictionary, or nullptr
+    size_t mappedDictionarySize = 0; //Size of the mapping
+
+    //The dictionary used for solving, pointing into either the built arena or the mapped file; not modified by solving
+    const char *dictionaryBytes = nullptr; //Start of the dictionary, beginning with its header
+    size_t dictionarySize = 0; //Size of the dictionary in bytes
+    const c_trie_node *trieNodes = nullptr; //Prefix trie of legal words, with the root at index 0
+    int trieNodeCount = 0; //Number of nodes in the trie
+    const c_symbol_alphabet *alphabet = nullptr; //Alphabet the legal words and boards are spelled with
+    int8_t symbolsByFirstByte[256]; //Per first byte of a symbol, its code if no other symbol starts with that byte, -2 if several do, or -1
+    bool lettersAreSymbols; //True if symbol i is the single letter 'a' + i for every symbol, as in the default alphabet
+    const int32_t *trieSubtreeWordCounts = nullptr; //Per trie node, the number of words at or below it; used to find start letters worth splitting up
+    int legalWordCount = 0; //Number of distinct words in the trie
+    const char *legalWordLetters = nullptr; //Letters of every legal word, packed together in alphabetical order
+    const int32_t *legalWordOffsets = nullptr; //legalWordCount + 1 offsets into legalWordLetters; word i runs from offset i up to offset i + 1
+    int maxWordLength = 0; //Length of the longest legal word, which limits how deep a search can go
+    c_solve_state solveState; //State used by solve_board
+    bool fixedSizeSearch = true; //False to search every board size with the general search, set by set_fixed_size_search
+    c_editable_board editableBoard; //Board set by set_board and changed by update_cell
+    mutable std::map<std::pair<int, int>, std::shared_ptr<const c_board_adjacency>> adjacencyCache; //Neighbour tables already built, by board width and height
+    mutable std::deque<std::pair<int, int>> adjacencyCacheOrder; //Shapes in adjacencyCache, oldest first
+    static const size_t maxCachedAdjacencies = 16; //Most shapes kept in adjacencyCache, so a caller trying many shapes doesn't fill memory with tables
+    mutable std::mutex adjacencyCacheMutex; //Guards adjacencyCache and adjacencyCacheOrder, since threads solving boards can add to them at the same time
+    std::shared_ptr<const c_board_adjacency> getAdjacency(int board_width, int board_height) const; //Returns the neighbour table for a board shape, building it the first time
+    template <class t_visited_set>
+    void searchPaths(c_solve_state &state, t_visited_set &visitedCells, c_search_frame *pathStack, int firstPosition, int secondPosition) const; //Main function to build word paths
+    template <int t_board_width, int t_board_height>
+    void searchFixedBoard(c_solve_state &state) const; //Searches every start cell of a board whose shape is known at compile time
+    void beginLegalWords(); //Clears the dictionary before adding words
+    bool addLegalWord(const char *wordLetters, size_t wordLength); //Normalizes a word and adds it to the built trie; returns false if the word isn't valid
+    static c_symbol_alphabet defaultAlphabet(); //Returns the alphabet of the letters 'a' to 'z'
+    void useAlphabet(const c_symbol_alphabet *newAlphabet); //Reads boards with the given alphabet
+    static int matchSymbol(const c_symbol_alphabet &symbolAlphabet, const char *text, size_t textLength, size_t &symbolLength); //Returns the code of the longest symbol at the start of the text, or -1
+    void finishLegalWords(); //Numbers the words added since beginLegalWords and starts using them for solving
+    void unmapDictionary(); //Releases the mapping of a dictionary loaded from a file, if there is one
+    static size_t alignDictionarySection(size_t sectionOffset) {return (sectionOffset + 7) & ~size_t(7);} //Rounds a section of a dictionary up to 8 bytes
+    static void getDictionarySections(const c_dictionary_file_header &header, size_t sectionOffsets[5]); //Works out where each section of a dictionary starts, and its total size
+    bool useDictionary(const char *newDictionaryBytes, size_t newDictionarySize); //Checks a dictionary's header and starts solving against it; returns false if it isn't valid
+    bool subtreeIsPossible(const c_solve_state &state, int currentNode) const //Returns false if every word at or below the node needs a symbol the board doesn't have
+    {
+        return (trieNodes[currentNode].subtreeLetters & ~state.boardLetterMask) == 0;
+    }
+    static int trieChild(const c_trie_node *nodes, int currentNode, int letterIndex) //Returns the child of a trie node for symbol letterIndex, or -1 if there isn't one
+    {
+        uint32_t childLetters = nodes[currentNode].childLetters;
+        if(!((childLetters >> letterIndex) & 1))
+        {
+            return -1;
+        }
+        return nodes[currentNode].firstChild + __builtin_popcount(childLetters & ((uint32_t(1) << letterIndex) - 1));
+    }
+    int wordLetterCount(int wordIndex) const //Returns the number of letters in a legal word, counting every letter of a symbol such as "qu"
+    {
+        int wordLetters = 0;
+        for(int letterIndex = legalWordOffsets[wordIndex]; letterIndex < legalWordOffsets[wordIndex + 1]; letterIndex++)
+        {
+            wordLetters += ((unsigned char)legalWordLetters[letterIndex] & 0xC0) != 0x80; //Count UTF-8 characters, not bytes
+        }
+        return wordLetters;
+    }
+    int wordScore(int wordIndex) const //Returns the points for a legal word under standard Boggle scoring
+    {
+        static const int scoresByLength[9] = {0, 0, 0, 1, 1, 2, 3, 5, 11};
+        return scoresByLength[std::min(wordLetterCount(wordIndex), 8)];
+    }
+    template <class t_search_frame>
+    void addFoundWord(c_solve_state &state, int wordIndex, const t_search_frame *pathStack, int pathLength) const //Adds a word to the words found on the board, with the path on the stack that spells it
+    {
+        state.resultWordIndexes.push_back(wordIndex);
+        state.wordFoundGeneration[wordIndex] = state.solveGeneration; //Mark the word as found so it isn't added to the solution list twice
+        if(state.scoreWords || state.recordPaths)
+        {
+            int foundScore = wordScore(wordIndex);
+            state.totalScore += foundScore;
+            if(state.recordPaths)
+            {
+                state.foundWords.push_back({wordIndex, foundScore, (uint32_t)state.foundPathPositions.size(), (uint32_t)pathLength});
+                for(int stackIndex = 0; stackIndex < pathLength; stackIndex++)
+                {
+                    state.foundPathPositions.push_back(pathStack[stackIndex].position);
+                }
+            }
+        }
+    }
+    std::vector<std::string> wordsFromIndexes(const std::vector<int> &wordIndexes) const; //Copies out the words with the given indexes
+    c_board_status beginSolve(c_solve_state &state, int board_width, int board_height, const char *board_letters) const; //Prepares the state for a new board, without printing anything if the board is invalid
+    static void reportBoardStatus(c_board_status board_status); //Prints why a board is invalid, once per board, for the calls that have no other way to say so
+    void searchFromPath(c_solve_state &state, int firstPosition, int secondPosition) const; //Finds all words whose path starts with the given cells; secondPosition can be -1
+    void countWordPath(int wordIndex, int pathCountChange); //Adds to the number of editable board paths spelling a word, adding or removing it from the words found
+    int addBoardPath(int position, int node, int parent); //Adds a path of the editable board and returns it
+    int boardPathChild(int path, int symbol) const //Returns the trie node of a path extended by a symbol, or -1 if no word starts that way
+    {
+        const c_board_path &boardPath = editableBoard.paths[path];
+        if(!((boardPath.trieChildLetters >> symbol) & 1))
+        {
+            return -1;
+        }
+        return boardPath.trieFirstChild + __builtin_popcount(boardPath.trieChildLetters & ((uint32_t(1) << symbol) - 1));
+    }
+    void removeBoardPath(int path); //Removes a path of the editable board, and every longer path starting with it
+    void growBoardPaths(int path); //Adds every path of the editable board that starts with the given path
+    const std::vector<int> &solveWithState(c_solve_state &state, int board_width, int board_height, const char *board_letters, bool scoreWords = false, bool recordPaths = false) const; //Solves one board using the given state, returning sorted word indexes
+    void searchBoard(c_solve_state &state) const; //Finds the words on the board prepared by beginSolve, leaving them sorted in state.resultWordIndexes
+    void boundFromPath(c_solve_state &state, int *pathPositions, int pathLength, int currentNode, int maxPathCells, int &wordCount) const; //Counts the words spelled by paths shorter than maxPathCells starting with the given path, and collects the nodes of paths that long
+
+public:
+	c_boggle();
+	~c_boggle();
+
+	// before set_legal_words, choose the symbols that board cells and words are made of, in the order words
+	// should be sorted; the default is the letters "a" to "z". A symbol is up to 7 bytes of text, so it can
+	// be a multi-letter tile such as the "qu" of a retail Boggle game, or a UTF-8 character. Returns false,
+	// keeping the current alphabet, if there are more than 32 symbols or one is empty, too long or repeated
+	bool set_alphabet(
+		const std::vector<std::string> &symbols); // text of each symbol; ASCII letters are converted to lowercase
+
+	// prior to solving any board, configure the legal words; uppercase letters are converted to lowercase, and
+	// words that can't be spelled with the symbols of the alphabet are skipped. Words are split into symbols by
+	// taking the longest symbol that matches at each point
+	void set_legal_words(
+		const std::vector<std::string> &all_words); // array of legal words, in any order
+
+	// as an alternative to set_legal_words, read the legal words from a stream with one word per line, adding
+	// each one to the dictionary as it is read; returns the number of non-empty lines that were skipped, or -1
+	// if reading fails, in which case the legal words from before are kept
+	int load_legal_words(
+		std::istream &word_stream);	// stream of legal words, in any order
+
+	// same as above, reading from a file descriptor such as 0 for standard input
+	int load_legal_words(
+		int file_descriptor);		// open file descriptor to read legal words from
+
+	// write the legal words configured by set_legal_words to a compiled dictionary file, so later runs can
+	// load it with load_dictionary instead of building it again; returns false if the file can't be written
+	bool save_dictionary(
+		const char *file_path) const;	// path of the file to write
+
+	// as an alternative to set_legal_words, map a dictionary file written by save_dictionary into memory and
+	// solve against it directly; processes loading the same file share its pages. Returns false if the
+	// file can't be read, isn't a compiled dictionary, or has any index or offset out of range
+	bool load_dictionary(
+		const char *file_path);		// path of the file to load
+
+	// the common board sizes 4x4, 5x5 and 6x6 are searched by solvers specialized for their shape; pass false to
+	// search them with the general search like any other size, to measure or check the specialized ones. On by default
+	void set_fixed_size_search(
+		bool use_fixed_size_search);	// true to use the specialized solvers
+
+	// find all words on the specified board, returning a list of them; the legal words are not modified,
+	// so any number of boards can be solved after a single call to set_legal_words. The search counters
+	// are only collected when built with BOGGLE_SOLVER_STATS enabled, and are left at zero otherwise
+	std::vector<std::string> solve_board(
+		int board_width,		// width of the board, e.g. 4 for a retail Boggle game
+		int board_height,		// height of the board, e.g. 4 for a retail Boggle game
+		const char *board_letters,	// board_width*board_height cells in row major order, each the text of a symbol such as "qu"
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters for the board
+
+	// same as above, but returns the alphabetical indexes of the words found instead of copies of them; indexes are
+	// sorted, so they are in the same order as the words, and can be turned into words with legal_word
+	std::vector<int> solve_board_word_indexes(
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters,	// board_width*board_height cells in row major order
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters for the board
+
+	// same as above, but returns views of the words, which point into the legal words and stay valid
+	// until set_legal_words is called again
+	std::vector<std::string_view> solve_board_word_views(
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters,	// board_width*board_height cells in row major order
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters for the board
+
+	// returns the legal word with the given alphabetical index, as found by solve_board_word_indexes
+	std::string_view legal_word(
+		int word_index) const;		// index from 0 up to the number of legal words
+
+	// scratch space for solving boards on threads of your own, such as the workers of a server: each thread keeps
+	// one and passes it to the const version of solve_board_word_indexes below, which only reads the legal words,
+	// so any number of threads can solve against the same c_boggle at once
+	struct c_solve_workspace
+	{
+		c_solve_state state; // used only by c_boggle
+	};
+
+	// same as solve_board_word_indexes, using the given workspace instead of one owned by this object; fills in
+	// word_indexes, reusing its storage, and returns false if the board is invalid. Unlike the other solve calls
+	// it prints nothing for an invalid board, so a server can answer with its own error instead
+	bool solve_board_word_indexes(
+		c_solve_workspace &workspace,	// scratch space owned by the calling thread
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters,	// board_width*board_height cells in row major order
+		std::vector<int> &word_indexes,	// receives the alphabetical indexes of the words found, sorted
+		int *board_score = nullptr) const; // if not null, receives the total score of the board, as from solve_board_score
+
+	// returns an upper bound on the number of words solve_board would find, much more cheaply than solving: every path of up
+	// to path_cells cells is followed, words that short are counted exactly, and each longer word is counted as part of all
+	// the words starting with its first path_cells symbols, unless they need a symbol the board doesn't have. A larger
+	// path_cells gives a tighter bound for more work. Returns 0 if the board is invalid
+	int word_count_upper_bound(
+		c_solve_workspace &workspace,	// scratch space owned by the calling thread
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters,	// board_width*board_height cells in row major order
+		int path_cells = 3) const;	// length of the paths followed, from 1 to 8
+
+	// same as solve_board, but also scores each word under standard Boggle scoring (3 or 4 letters: 1 point, 5: 2,
+	// 6: 3, 7: 5, 8 or more: 11, with a tile such as "qu" counting as all of its letters) and records the cells of
+	// the first path found for each, all during the search. Fills in scored_board, reusing its storage, and returns
+	// false if the board is invalid or has more than 256 cells, since path positions are stored in a byte each
+	bool solve_board_scored(
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters,	// board_width*board_height cells in row major order
+		c_boggle_scored_board &scored_board, // receives the words found, their scores and paths, and the total score
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters for the board
+
+	// returns the total score of the specified board, adding up the scores of the words as the search finds them
+	// without copying out any words; returns 0 if the board is invalid
+	int solve_board_score(
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters,	// board_width*board_height cells in row major order
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters for the board
+
+	// same as solve_board, for a board size known at compile time; the common sizes 4x4, 5x5 and 6x6 are
+	// dispatched to this automatically by the runtime version
+	template <int t_board_width, int t_board_height>
+	std::vector<std::string> solve_board(
+		const char *board_letters,	// t_board_width*t_board_height cells in row major order
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters for the board
+
+	// keep a board for editing one cell at a time: finds the same words as solve_board, and also keeps every
+	// path that spells the start of a word, so that update_cell only has to search the paths through the cell
+	// it changes. Meant for boards of ordinary size, since a very large board has a great many such paths.
+	// Returns false if the board is invalid
+	bool set_board(
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters);	// board_width*board_height cells in row major order
+
+	// change one cell of the board kept by set_board, searching only the paths that pass through it; words whose
+	// paths all avoid the cell are kept without being searched again. Returns false, leaving the board unchanged,
+	// if the position is off the board or the text isn't a single symbol of the alphabet
+	bool update_cell(
+		int cell_position,		// row major position of the cell, from 0 up to board_width*board_height
+		const char *cell_letters);	// new text of the cell, such as "e" or "qu"
+
+	// returns the words on the board kept by set_board after any changes made with update_cell; the same list
+	// solve_board would return for the board as it is now
+	std::vector<std::string> board_words() const;
+
+	// same as above, but returns the alphabetical indexes of the words, sorted
+	std::vector<int> board_word_indexes() const;
+
+	// returns the number of words on the board kept by set_board, without copying them out
+	int board_word_count() const;
+
+	// returns the total score of the words on the board kept by set_board, kept up to date by update_cell
+	int board_score() const;
+
+	// returns the number of letters in the longest word on the board kept by set_board, counting every letter of
+	// a symbol such as "qu", or 0 if the board has no words; kept up to date by update_cell, so nothing is copied
+	int board_longest_word() const;
+
+	// find all words on each of the specified boards, splitting the boards across worker threads that share
+	// the legal words; returns one list of words per board, in the same order as the boards
+	std::vector<std::vector<std::string>> solve_boards(
+		const c_boggle_board *boards,	// boards to solve
+		size_t board_count,		// number of boards
+		int thread_count = 0,		// number of worker threads; 0 uses one per hardware thread
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters added up over all boards
+
+	// find all words on a single board using several worker threads, which is worthwhile for very large boards;
+	// returns the same list as solve_board
+	std::vector<std::string> solve_board_parallel(
+		int board_width,		// width of the board
+		int board_height,		// height of the board
+		const char *board_letters,	// board_width*board_height cells in row major order
+		int thread_count = 0,		// number of worker threads; 0 uses one per hardware thread
+		c_boggle_solve_stats *solve_stats = nullptr); // if not null, receives the search counters added up over all threads
+
+	// check each board reading kernel the processor supports against the plain C++ version, on random text of
+	// lowercase and uppercase letters, punctuation and non-ASCII bytes, at lengths that leave partial blocks over;
+	// prints a line per kernel and returns false if any gives a different result
+	static bool check_board_kernels();
+};
+
+//Search every start cell of a board whose shape is a template parameter. This is the same search as searchPaths, specialized
+//for the known size: the board letters are converted to trie child indexes once up front, and each letter on the stack keeps
+//a mask of its unvisited neighbours, so finding the next neighbour to try is a bit scan instead of a table lookup and test
+template <int t_board_width, int t_board_height>
+void c_boggle::searchFixedBoard(c_solve_state &state) const
+{
+    static_assert(t_board_width * t_board_height <= 64, "Fixed size boards must fit in a 64-bit visited mask");
+    static constexpr c_fixed_board_adjacency<t_board_width, t_board_height> neighbours;
+    constexpr int fixedBoardSize = t_board_width * t_board_height;
+
+    if(trieNodeCount == 0) //No legal words have been set
+    {
+        return;
+    }
+
+    uint64_t letterCells = 0; //Mask of the positions holding a symbol that can be part of a word
+    int letterIndexes[fixedBoardSize]; //Symbol code of the cell at each position, which is also its trie child index
+    for(int currentPosition = 0; currentPosition < fixedBoardSize; currentPosition++)
+    {
+        letterIndexes[currentPosition] = state.boardSymbols[currentPosition];
+        if(letterIndexes[currentPosition] >= 0)
+        {
+            letterCells |= uint64_t(1) << currentPosition;
+        }
+    }
+
+    c_fixed_search_frame pathStack[fixedBoardSize];
+    c_search_counters counters;
+    for(int firstPosition = 0; firstPosition < fixedBoardSize; firstPosition++)
+    {
+        c_start_cell_timer cellTimer(state.stats, firstPosition);
+        int firstNode = ((letterCells >> firstPosition) & 1) ? trieChild(trieNodes, 0, letterIndexes[firstPosition]) : -1;
+        if(firstNode == -1 || (state.filterSubtrees && !subtreeIsPossible(state, firstNode))) //If no legal word on this board starts with this letter, move on to the next letter
+        {
+            continue;
+        }
+        uint64_t visitedCells = ~letterCells | (uint64_t(1) << firstPosition); //Cells that can't be part of a word are never visited
+        pathStack[0] = {neighbours.neighbourMasks[firstPosition], firstPosition, firstNode};
+        int pathLength = 1;
+        counters.countNode(pathLength);
+        int firstWordIndex = trieNodes[firstNode].wordIndex;
+        if(firstWordIndex != -1 && state.wordFoundGeneration[firstWordIndex] != state.solveGeneration) //A symbol of three or more letters can be a word on its own
+        {
+            counters.countWordCheck();
+            addFoundWord(state, firstWordIndex, pathStack, pathLength);
+        }
+
+        while(pathLength > 0)
+        {
+            c_fixed_search_frame &currentFrame = pathStack[pathLength - 1];
+            uint64_t unvisitedNeighbours = currentFrame.remainingNeighbours & ~visitedCells;
+            if(unvisitedNeighbours == 0) //Every path through this letter has been checked
+            {
+                visitedCells &= ~(uint64_t(1) << currentFrame.position); //Unmark this letter as used for the current path
+                pathLength--;
+                continue;
+            }
+
+            int nextLetterPosition = __builtin_ctzll(unvisitedNeighbours); //Position of the possible next letter in the word
+            currentFrame.remainingNeighbours = unvisitedNeighbours & (unvisitedNeighbours - 1);
+            int nextNode = trieChild(trieNodes, currentFrame.node, letterIndexes[nextLetterPosition]);
+            if(nextNode != -1 && state.filterSubtrees && !subtreeIsPossible(state, nextNode)) //Every word starting with this substring needs a letter the board doesn't have
+            {
+                nextNode = -1;
+            }
+            counters.countProbe(nextNode);
+            if(nextNode == -1) //No legal word starts with this substring, so there is no need to follow this path
+            {
+                continue;
+            }
+
+            visitedCells |= uint64_t(1) << nextLetterPosition; //Mark the new letter as used in the current path
+            pathStack[pathLength++] = {neighbours.neighbourMasks[nextLetterPosition], nextLetterPosition, nextNode};
+            counters.countNode(pathLength);
+            int wordIndex = trieNodes[nextNode].wordIndex;
+            if(wordIndex != -1)
+            {
+                counters.countWordCheck();
+                if(state.wordFoundGeneration[wordIndex] != state.solveGeneration) //Substring is a legal word long enough to be a solution word, and hasn't been found on this board yet
+                {
+                    addFoundWord(state, wordIndex, pathStack, pathLength); //Add word to solution list
+                }
+            }
+        }
+    }
+    counters.addTo(state.stats);
+}
+
+template <int t_board_width, int t_board_height>
+std::vector<std::string> c_boggle::solve_board(const char *board_letters, c_boggle_solve_stats *solve_stats)
+{
+    c_board_status boardStatus = beginSolve(solveState, t_board_width, t_board_height, board_letters);
+    if(boardStatus == board_valid)
+    {
+        searchFixedBoard<t_board_width, t_board_height>(solveState);
+        std::sort(solveState.resultWordIndexes.begin(), solveState.resultWordIndexes.end());
+    }
+    reportBoardStatus(boardStatus);
+    if(solve_stats)
+    {
+        *solve_stats = solveState.stats;
+    }
+    return wordsFromIndexes(solveState.resultWordIndexes);
+}
+
+#endif //BOGGLE_SOLVER_H
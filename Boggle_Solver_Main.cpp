@@ -0,0 +1,70 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Board Solver
+//Program Description: Example program for c_boggle: solves a small example board, or with
+//--compile <word list> <dictionary file>, compiles a word list into a dictionary file for load_dictionary, or with
+//--check-kernels, checks the board reading kernels the processor supports against the plain C++ versions, as
+//Boggle_Solver_Test also does
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Solver.h"
+#include <cstring>
+#include <iostream>
+#include <fstream>
+
+void example_driver()
+{
+	c_boggle my_boggle;
+	std::vector<std::string> my_results;
+
+	my_boggle.set_legal_words({"abed","abo","aby","aero","aery","bad","bade","be","bead","bed","boa","board","bore","bored","box","boy","bread","bred","bro","broad","byre","byroad","dab","deb","derby","dev","dove","oba","obe","orb","orbed","orby","ore","oread","read","reb","red","rev","road","rob","robe","robed","robbed","robber","robed","verb","very","yob","yore"});
+	my_results= my_boggle.solve_board(3, 3, "yoxrbaved");
+    for (std::string word : my_results)
+    {
+        std::cout << word << std::endl;
+    }
+}
+
+//Offline dictionary compiler: read a word list with one word per line, or standard input if the path is "-",
+//and write it out as a compiled dictionary file
+bool compile_dictionary(const char *word_list_path, const char *dictionary_path)
+{
+    c_boggle my_boggle;
+    int rejectedWordCount;
+    if(std::strcmp(word_list_path, "-") == 0)
+    {
+        rejectedWordCount = my_boggle.load_legal_words(0);
+    }
+    else
+    {
+        std::ifstream wordListFile(word_list_path);
+        if(!wordListFile)
+        {
+            std::cout << "Could not open word list " << word_list_path << std::endl;
+            return false;
+        }
+        rejectedWordCount = my_boggle.load_legal_words(wordListFile);
+    }
+    if(rejectedWordCount < 0)
+    {
+        return false;
+    }
+    if(rejectedWordCount > 0)
+    {
+        std::cout << "Skipped " << rejectedWordCount << " words with characters other than letters" << std::endl;
+    }
+    return my_boggle.save_dictionary(dictionary_path);
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc == 4 && std::strcmp(argv[1], "--compile") == 0) //Boggle_Solver --compile <word list> <dictionary file>
+    {
+        return compile_dictionary(argv[2], argv[3]) ? 0 : 1;
+    }
+    if(argc == 2 && std::strcmp(argv[1], "--check-kernels") == 0) //Boggle_Solver --check-kernels
+    {
+        return c_boggle::check_board_kernels() ? 0 : 1;
+    }
+    example_driver();
+}
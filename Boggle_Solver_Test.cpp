@@ -0,0 +1,259 @@
+//*******************************************************************************************************
+//Author: Jack Moon
+//Program Name: Boggle Solver Tests
+//Program Description: Checks c_boggle against slower or simpler ways of getting the same answers. Each check
+//prints a line saying whether it passed, and the program exits with 1 if any failed, so a build can run it
+//after every change.
+//Build: g++ -std=c++17 -O2 -pthread Boggle_Solver.cpp Boggle_Solver_Test.cpp -o Boggle_Solver_Test
+//Last Updated: 04/13/21
+//*******************************************************************************************************
+#include "Boggle_Solver.h"
+#include <iostream>
+#include <random>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Letters weighted by how often they appear in English text, so boards and words share enough prefixes to find words
+static const char englishLetters[] = "eeeeeeeeeeeetttttttttaaaaaaaaooooooooiiiiiiinnnnnnnsssssshhhhhhrrrrrrddddllllccuuummwwffggyyppbbvkjxqz";
+
+static std::string randomLetters(std::mt19937 &generator, int letter_count)
+{
+    std::string letters;
+    for(int letterIndex = 0; letterIndex < letter_count; letterIndex++)
+    {
+        letters += englishLetters[generator() % (sizeof(englishLetters) - 1)];
+    }
+    return letters;
+}
+
+//A synthetic dictionary of 50000 words of 3 to 10 letters, the same on every run
+static c_boggle &testDictionary()
+{
+    static c_boggle dictionary;
+    static bool dictionaryBuilt = [] (c_boggle &newDictionary)
+    {
+        std::mt19937 generator(1);
+        std::vector<std::string> words;
+        for(int wordNumber = 0; wordNumber < 50000; wordNumber++)
+        {
+            words.push_back(randomLetters(generator, 3 + generator() % 4 + generator() % 5));
+        }
+        newDictionary.set_legal_words(words);
+        return true;
+    }(dictionary);
+    (void)dictionaryBuilt;
+    return dictionary;
+}
+
+//Prints how a check went and returns whether it passed
+static bool reportCheck(const char *check_name, int mismatch_count)
+{
+    std::cout << check_name << ": " << (mismatch_count == 0 ? "passed" : "FAILED " + std::to_string(mismatch_count) + " times") << std::endl;
+    return mismatch_count == 0;
+}
+
+//The solvers specialized for 4x4, 5x5 and 6x6 boards must find the same words as the general search
+static bool checkFixedSizeSearch()
+{
+    c_boggle &dictionary = testDictionary();
+    std::mt19937 generator(2);
+    int mismatchCount = 0;
+    for(int boardSize = 4; boardSize <= 6; boardSize++)
+    {
+        for(int boardNumber = 0; boardNumber < 300; boardNumber++)
+        {
+            std::string boardLetters = randomLetters(generator, boardSize * boardSize);
+            dictionary.set_fixed_size_search(true);
+            std::vector<int> fixedWords = dictionary.solve_board_word_indexes(boardSize, boardSize, boardLetters.c_str());
+            dictionary.set_fixed_size_search(false);
+            std::vector<int> generalWords = dictionary.solve_board_word_indexes(boardSize, boardSize, boardLetters.c_str());
+            mismatchCount += fixedWords != generalWords;
+        }
+    }
+    dictionary.set_fixed_size_search(true);
+    return reportCheck("Fixed size search against the general search", mismatchCount);
+}
+
+//A board kept with set_board and changed a cell at a time with update_cell must have the same words, score and longest word,
+//after every change, as solving its letters from scratch; a few changes are off the board or not a symbol, and must leave it as it was
+static bool checkUpdateCell()
+{
+    c_boggle &dictionary = testDictionary();
+    std::mt19937 generator(3);
+    const int boardShapes[][2] = {{3, 3}, {4, 4}, {5, 5}, {4, 7}, {1, 6}};
+    int mismatchCount = 0;
+    for(const int *boardShape : boardShapes)
+    {
+        int boardWidth = boardShape[0], boardHeight = boardShape[1], boardSize = boardWidth * boardHeight;
+        std::string boardLetters = randomLetters(generator, boardSize);
+        if(!dictionary.set_board(boardWidth, boardHeight, boardLetters.c_str()))
+        {
+            mismatchCount++;
+            continue;
+        }
+        for(int changeNumber = 0; changeNumber < 500; changeNumber++)
+        {
+            int cellPosition = generator() % boardSize;
+            std::string cellLetters = randomLetters(generator, 1);
+            bool isValidChange = true;
+            if(changeNumber == 100 || changeNumber == 200) //Off the board
+            {
+                cellPosition = changeNumber == 100 ? -1 : boardSize;
+                isValidChange = false;
+            }
+            else if(changeNumber == 300 || changeNumber == 400) //Not a symbol
+            {
+                cellLetters = changeNumber == 300 ? "7" : "ee";
+                isValidChange = false;
+            }
+            if(dictionary.update_cell(cellPosition, cellLetters.c_str()) != isValidChange)
+            {
+                mismatchCount++;
+            }
+            if(isValidChange)
+            {
+                boardLetters[cellPosition] = cellLetters[0];
+            }
+            int longestWord = 0;
+            for(const std::string &word : dictionary.solve_board(boardWidth, boardHeight, boardLetters.c_str()))
+            {
+                longestWord = std::max(longestWord, (int)word.length());
+            }
+            if(dictionary.board_word_indexes() != dictionary.solve_board_word_indexes(boardWidth, boardHeight, boardLetters.c_str())
+                || dictionary.board_score() != dictionary.solve_board_score(boardWidth, boardHeight, boardLetters.c_str())
+                || dictionary.board_word_count() != (int)dictionary.board_word_indexes().size() || dictionary.board_longest_word() != longestWord)
+            {
+                mismatchCount++;
+            }
+        }
+    }
+    return reportCheck("update_cell against solving from scratch", mismatchCount);
+}
+
+//solve_board_parallel, which splits one board's start cells across threads that steal work from each other, and solve_boards,
+//which shares a batch of boards between threads, must find the same words as solve_board on one thread, whatever the number of
+//threads; 0 threads uses one per hardware thread
+static bool checkThreadedSolves()
+{
+    c_boggle &dictionary = testDictionary();
+    std::mt19937 generator(4);
+    const int threadCounts[] = {1, 2, 3, 0};
+    int mismatchCount = 0;
+
+    const int parallelShapes[][2] = {{100, 100}, {20, 30}, {5, 5}, {1, 1}};
+    for(const int *boardShape : parallelShapes)
+    {
+        std::string boardLetters = randomLetters(generator, boardShape[0] * boardShape[1]);
+        std::vector<std::string> serialWords = dictionary.solve_board(boardShape[0], boardShape[1], boardLetters.c_str());
+        for(int threadCount : threadCounts)
+        {
+            mismatchCount += dictionary.solve_board_parallel(boardShape[0], boardShape[1], boardLetters.c_str(), threadCount) != serialWords;
+        }
+    }
+
+    const int batchShapes[][2] = {{4, 4}, {5, 5}, {6, 6}, {3, 8}, {1, 1}, {10, 10}, {2, 2}, {40, 25}};
+    std::vector<std::string> batchLetters;
+    std::vector<c_boggle_board> batchBoards;
+    for(int boardNumber = 0; boardNumber < 200; boardNumber++)
+    {
+        const int *boardShape = batchShapes[boardNumber % (sizeof(batchShapes) / sizeof(batchShapes[0]))];
+        batchLetters.push_back(randomLetters(generator, boardShape[0] * boardShape[1]));
+        batchBoards.push_back({boardShape[0], boardShape[1], nullptr});
+    }
+    std::vector<std::vector<std::string>> serialBatchWords;
+    for(size_t boardIndex = 0; boardIndex < batchBoards.size(); boardIndex++)
+    {
+        batchBoards[boardIndex].board_letters = batchLetters[boardIndex].c_str(); //The strings are all in place now, so their text won't move
+        serialBatchWords.push_back(dictionary.solve_board(batchBoards[boardIndex].board_width, batchBoards[boardIndex].board_height, batchBoards[boardIndex].board_letters));
+    }
+    for(int threadCount : threadCounts)
+    {
+        std::vector<std::vector<std::string>> batchWords = dictionary.solve_boards(batchBoards.data(), batchBoards.size(), threadCount);
+        for(size_t boardIndex = 0; boardIndex < batchBoards.size(); boardIndex++)
+        {
+            mismatchCount += boardIndex >= batchWords.size() || batchWords[boardIndex] != serialBatchWords[boardIndex];
+        }
+    }
+    return reportCheck("solve_board_parallel and solve_boards against solve_board", mismatchCount);
+}
+
+//load_legal_words must find the same words as set_legal_words when its file descriptor hands over the list a few bytes at a time,
+//splitting lines between reads, and when reading fails it must return -1 and keep the legal words it had
+static bool checkLoadLegalWords()
+{
+    std::mt19937 generator(5);
+    std::vector<std::string> legalWords;
+    std::string wordList;
+    for(int wordNumber = 0; wordNumber < 5000; wordNumber++)
+    {
+        legalWords.push_back(randomLetters(generator, 3 + generator() % 6));
+        wordList += legalWords.back() + (wordNumber % 7 == 0 ? "\n\n" : "\n");
+    }
+    wordList += "unterminated"; //Last line without a newline
+    legalWords.push_back("unterminated");
+    c_boggle expectedDictionary, loadedDictionary;
+    expectedDictionary.set_legal_words(legalWords);
+
+    int mismatchCount = 0;
+    int pipeEnds[2];
+    if(pipe(pipeEnds) != 0)
+    {
+        return reportCheck("load_legal_words against set_legal_words", 1);
+    }
+    std::thread writer([&] ()
+    {
+        for(size_t writtenLength = 0; writtenLength < wordList.length(); )
+        {
+            size_t chunkLength = std::min<size_t>(1 + writtenLength % 13, wordList.length() - writtenLength);
+            ssize_t bytesWritten = write(pipeEnds[1], wordList.data() + writtenLength, chunkLength);
+            if(bytesWritten <= 0)
+            {
+                break;
+            }
+            writtenLength += bytesWritten;
+        }
+        close(pipeEnds[1]);
+    });
+    mismatchCount += loadedDictionary.load_legal_words(pipeEnds[0]) != 0;
+    writer.join();
+    close(pipeEnds[0]);
+
+    std::vector<std::string> boards;
+    for(int boardNumber = 0; boardNumber < 50; boardNumber++)
+    {
+        boards.push_back(randomLetters(generator, 25));
+        mismatchCount += loadedDictionary.solve_board(5, 5, boards.back().c_str()) != expectedDictionary.solve_board(5, 5, boards.back().c_str());
+    }
+
+    int directoryDescriptor = open(".", O_RDONLY); //Reading a directory fails with EISDIR
+    if(directoryDescriptor < 0 || loadedDictionary.load_legal_words(directoryDescriptor) != -1)
+    {
+        mismatchCount++;
+    }
+    if(directoryDescriptor >= 0)
+    {
+        close(directoryDescriptor);
+    }
+    for(const std::string &boardLetters : boards)
+    {
+        mismatchCount += loadedDictionary.solve_board(5, 5, boardLetters.c_str()) != expectedDictionary.solve_board(5, 5, boardLetters.c_str());
+    }
+    return reportCheck("load_legal_words against set_legal_words", mismatchCount);
+}
+
+int main()
+{
+    bool allPassed = true;
+
+    //The SIMD board reading kernels must give the same cells and symbol sets as the plain C++ versions
+    allPassed = c_boggle::check_board_kernels() && allPassed;
+    allPassed = checkFixedSizeSearch() && allPassed;
+    allPassed = checkUpdateCell() && allPassed;
+    allPassed = checkThreadedSolves() && allPassed;
+    allPassed = checkLoadLegalWords() && allPassed;
+
+    std::cout << (allPassed ? "All checks passed" : "SOME CHECKS FAILED") << std::endl;
+    return allPassed ? 0 : 1;
+}